@@ -5,9 +5,12 @@
 #include <kernel/config.h>
 #include <kernel/save.h>
 
+#include "economy.h"
+
 #include <storage.h>
 
 void eressea_free_game(void) {
+  free_allocations();
   free_gamedata();
 }
 
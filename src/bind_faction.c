@@ -392,6 +392,7 @@ static int tolua_faction_set_race(lua_State * L)
   race *rc = rc_find(name);
   if (rc != NULL) {
     self->race = rc;
+    recount_faction(self);
   }
 
   return 0;
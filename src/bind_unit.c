@@ -253,7 +253,9 @@ static int tolua_unit_get_flags(lua_State * L)
 static int tolua_unit_set_flags(lua_State * L)
 {
   unit *self = (unit *) tolua_tousertype(L, 1, 0);
+  update_faction_counts(self, -1);
   self->flags = (int)tolua_tonumber(L, 2, 0);
+  update_faction_counts(self, 1);
   return 0;
 }
 
@@ -849,13 +851,9 @@ static int tolua_unit_set_race(lua_State * L)
   const char *rcname = tolua_tostring(L, 2, 0);
   race *rc = rc_find(rcname);
   if (rc != NULL) {
-    if (count_unit(self))
-      --self->faction->no_units;
     if (self->irace == u_race(self))
       self->irace = NULL;
     u_setrace(self, rc);
-    if (count_unit(self))
-      --self->faction->no_units;
   }
   return 0;
 }
@@ -486,7 +486,7 @@ static void reset_game(void)
     building *b;
     r->flags &= RF_SAVEMASK;
     for (u = r->units; u; u = u->next) {
-      u->flags &= UFL_SAVEMASK;
+      u->flags &= (UFL_SAVEMASK | UFL_MIGRANT);
     }
     for (b = r->buildings; b; b = b->next) {
       b->flags &= BLD_SAVEMASK;
@@ -1112,7 +1112,7 @@ static char *cr_output_resource(char *buf, const char *name,
 }
 
 static void
-cr_borders(seen_region ** seen, const region * r, const faction * f,
+cr_borders(seen_map * seen, const region * r, const faction * f,
   int seemode, FILE * F)
 {
   direction_t d;
@@ -1463,10 +1463,9 @@ report_computer(const char *filename, report_context * ctx, const char *charset)
   int i;
   faction *f = ctx->f;
   const char *prefix;
-  region *r;
   const char *mailto = locale_string(f->locale, "mailto");
   const attrib *a;
-  seen_region *sr = NULL;
+  seen_region *sr, *send = ctx->seen->regions + ctx->seen->size;
 #if SCORE_MODULE
   int score = 0, avgscore = 0;
 #endif
@@ -1647,10 +1646,7 @@ report_computer(const char *filename, report_context * ctx, const char *charset)
   }
 
   /* traverse all regions */
-  for (r = ctx->first; sr == NULL && r != ctx->last; r = r->next) {
-    sr = find_seen(ctx->seen, r);
-  }
-  for (; sr != NULL; sr = sr->next) {
+  for (sr = ctx->seen->regions; sr != send; ++sr) {
     cr_output_region(F, ctx, sr);
   }
   report_crtypes(F, f->locale);
@@ -65,6 +65,7 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include <util/lists.h>
 #include <util/message.h>
 #include <util/parser.h>
+#include <util/rand.h>
 #include <util/rng.h>
 
 #include <attributes/reduceproduction.h>
@@ -102,6 +103,7 @@ static int entertaining;
 
 static int norders;
 static request *oa;
+static wdist odist;
 
 #define RECRUIT_MERGE 1
 #define RECRUIT_CLASSIC 2
@@ -138,25 +140,18 @@ int income(const unit * u)
   }
 }
 
-static void scramble(void *data, int n, size_t width)
-{
-  int j;
-  char temp[64];
-  assert(width <= sizeof(temp));
-  for (j = 0; j != n; ++j) {
-    int k = rng_int() % n;
-    if (k == j)
-      continue;
-    memcpy(temp, (char *)data + j * width, width);
-    memcpy((char *)data + j * width, (char *)data + k * width, width);
-    memcpy((char *)data + k * width, temp, width);
-  }
-}
-
+/* Die requests werden nicht mehr in einzelne Stcke aufgeteilt und
+ * gemischt. Jeder request steht einmal in oa, mit qty als Gewicht, und
+ * nextorder() zieht daraus zufllig ohne Zurcklegen. Das ergibt dieselbe
+ * Verteilung wie das Mischen von norders einzelnen Stcken. Wo nur die
+ * Anzahl zhlt, verteilt splitorders() alle Stcke auf einmal, und ein
+ * request, der nicht mehr erfllt werden kann, fllt mit droporder() aus
+ * der Ziehung. */
 static void expandorders(region * r, request * requests)
 {
   unit *u;
   request *o;
+  int n = 0;
 
   /* Alle Units ohne request haben ein -1, alle units mit orders haben ein
    * 0 hier stehen */
@@ -169,23 +164,24 @@ static void expandorders(region * r, request * requests)
   for (o = requests; o; o = o->next) {
     if (o->qty > 0) {
       norders += o->qty;
+      ++n;
     }
   }
 
   if (norders > 0) {
     int i = 0;
-    oa = (request *) calloc(norders, sizeof(request));
+    int *weights = (int *)malloc(n * sizeof(int));
+    oa = (request *) calloc(n, sizeof(request));
     for (o = requests; o; o = o->next) {
       if (o->qty > 0) {
-        int j;
-        for (j = o->qty; j; j--) {
-          oa[i] = *o;
-          oa[i].unit->n = 0;
-          i++;
-        }
+        oa[i] = *o;
+        oa[i].unit->n = 0;
+        weights[i] = o->qty;
+        i++;
       }
     }
-    scramble(oa, norders, sizeof(request));
+    wdist_init(&odist, weights, n);
+    free(weights);
   } else {
     oa = NULL;
   }
@@ -197,6 +193,33 @@ static void expandorders(region * r, request * requests)
   }
 }
 
+/* Zieht den nchsten request, oder NULL wenn alle verteilt sind. */
+static request *nextorder(void)
+{
+  int i = wdist_draw(&odist);
+  return (i < 0) ? NULL : oa + i;
+}
+
+/* Wie oft jeder request unter den nchsten draws Ziehungen wre */
+static int *splitorders(int draws)
+{
+  int *counts = (int *)malloc(odist.size * sizeof(int));
+  wdist_split(&odist, draws, counts);
+  return counts;
+}
+
+static void droporder(const request * o)
+{
+  wdist_clear(&odist, (int)(o - oa));
+}
+
+static void free_requests(void)
+{
+  wdist_free(&odist);
+  free(oa);
+  oa = NULL;
+}
+
 /* ------------------------------------------------------------- */
 
 static void change_level(unit * u, skill_t sk, int bylevel)
@@ -205,7 +228,10 @@ static void change_level(unit * u, skill_t sk, int bylevel)
   assert(bylevel > 0);
   if (sv == 0)
     sv = add_skill(u, sk);
+  else
+    skillcount_change(u, sv, -u->number);
   sk_set(sv, sv->level + bylevel);
+  skillcount_change(u, sv, u->number);
 }
 
 typedef struct recruitment {
@@ -1414,18 +1440,18 @@ static void manufacture(unit * u, const item_type * itype, int want)
 }
 
 typedef struct allocation {
-  struct allocation *next;
   int want, get;
   double save;
   unsigned int flags;
   unit *unit;
 } allocation;
-#define new_allocation() calloc(sizeof(allocation), 1)
-#define free_allocation(a) free(a)
 
+/* Eine Liste pro Ressourcentyp. Die Arrays werden von Region zu Region
+ * wiederverwendet, split_allocations setzt nur size zurck. */
 typedef struct allocation_list {
   struct allocation_list *next;
   allocation *data;
+  int size, maxsize;
   const resource_type *type;
 } allocation_list;
 
@@ -1584,12 +1610,16 @@ static void allocate_resource(unit * u, const resource_type * rtype, int want)
     alist->type = rtype;
     allocations = alist;
   }
-  al = new_allocation();
+  if (alist->size == alist->maxsize) {
+    alist->maxsize = alist->maxsize ? alist->maxsize * 2 : 16;
+    alist->data = realloc(alist->data, alist->maxsize * sizeof(allocation));
+  }
+  al = alist->data + alist->size++;
   al->want = amount;
+  al->get = 0;
+  al->flags = 0;
   al->save = 1.0;
-  al->next = alist->data;
   al->unit = u;
-  alist->data = al;
 
   if (rdata->modifiers) {
     struct building *b = inside_building(u);
@@ -1616,8 +1646,22 @@ static int required(int want, double save)
   return norders;
 }
 
+/* Anteil von want an avail, wenn insgesamt norders angefordert wurden.
+ * Der Rest wird gewrfelt, so dass der Erwartungswert genau
+ * avail * want / norders ist. Rechnet in 64 bit, damit groe Mengen
+ * nicht berlaufen. */
+static int share(int avail, int want, int norders)
+{
+  long long prod = (long long)avail * want;
+  int x = (int)(prod / norders);
+  if (rng_int() % norders < (int)(prod % norders))
+    ++x;
+  return x;
+}
+
 static void
-leveled_allocation(const resource_type * rtype, region * r, allocation * alist)
+leveled_allocation(const resource_type * rtype, region * r, allocation * alist,
+  int size)
 {
   const item_type *itype = resource2item(rtype);
   rawmaterial *rm = rm_get(r, rtype);
@@ -1628,10 +1672,10 @@ leveled_allocation(const resource_type * rtype, region * r, allocation * alist)
     do {
       int avail = rm->amount;
       int norders = 0;
-      allocation *al;
+      allocation *al, *aend = alist + size;
 
       if (avail <= 0) {
-        for (al = alist; al; al = al->next) {
+        for (al = alist; al != aend; ++al) {
           al->get = 0;
         }
         break;
@@ -1639,7 +1683,7 @@ leveled_allocation(const resource_type * rtype, region * r, allocation * alist)
 
       assert(avail > 0);
 
-      for (al = alist; al; al = al->next)
+      for (al = alist; al != aend; ++al)
         if (!fval(al, AFL_DONE)) {
           int req = required(al->want - al->get, al->save);
           assert(al->get <= al->want && al->get >= 0);
@@ -1661,14 +1705,11 @@ leveled_allocation(const resource_type * rtype, region * r, allocation * alist)
       avail = MIN(avail, norders);
       if (need > 0) {
         int use = 0;
-        for (al = alist; al; al = al->next)
+        for (al = alist; al != aend; ++al)
           if (!fval(al, AFL_DONE)) {
             if (avail > 0) {
               int want = required(al->want - al->get, al->save);
-              int x = avail * want / norders;
-              /* Wenn Rest, dann wrfeln, ob ich was bekomme: */
-              if (rng_int() % norders < (avail * want) % norders)
-                ++x;
+              int x = share(avail, want, norders);
               avail -= x;
               use += x;
               norders -= want;
@@ -1688,15 +1729,16 @@ leveled_allocation(const resource_type * rtype, region * r, allocation * alist)
 }
 
 static void
-attrib_allocation(const resource_type * rtype, region * r, allocation * alist)
+attrib_allocation(const resource_type * rtype, region * r, allocation * alist,
+  int size)
 {
-  allocation *al;
+  allocation *al, *aend = alist + size;
   int norders = 0;
   attrib *a = a_find(rtype->attribs, &at_resourcelimit);
   resource_limit *rdata = (resource_limit *) a->data.v;
   int avail = rdata->value;
 
-  for (al = alist; al; al = al->next) {
+  for (al = alist; al != aend; ++al) {
     norders += required(al->want, al->save);
   }
 
@@ -1707,13 +1749,10 @@ attrib_allocation(const resource_type * rtype, region * r, allocation * alist)
   }
 
   avail = MIN(avail, norders);
-  for (al = alist; al; al = al->next) {
+  for (al = alist; al != aend; ++al) {
     if (avail > 0) {
       int want = required(al->want, al->save);
-      int x = avail * want / norders;
-      /* Wenn Rest, dann wrfeln, ob ich was bekomme: */
-      if (rng_int() % norders < (avail * want) % norders)
-        ++x;
+      int x = share(avail, want, norders);
       avail -= x;
       norders -= want;
       al->get = MIN(al->want, (int)(x / al->save));
@@ -1728,7 +1767,7 @@ attrib_allocation(const resource_type * rtype, region * r, allocation * alist)
 }
 
 typedef void (*allocate_function) (const resource_type *, struct region *,
-  struct allocation *);
+  struct allocation *, int);
 
 static allocate_function get_allocator(const struct resource_type *rtype)
 {
@@ -1746,20 +1785,24 @@ static allocate_function get_allocator(const struct resource_type *rtype)
 
 void split_allocations(region * r)
 {
-  allocation_list **p_alist = &allocations;
+  allocation_list *alist;
   freset(r, RF_SELECT);
-  while (*p_alist) {
-    allocation_list *alist = *p_alist;
+  for (alist = allocations; alist; alist = alist->next) {
     const resource_type *rtype = alist->type;
-    allocate_function alloc = get_allocator(rtype);
-    const item_type *itype = resource2item(rtype);
-    allocation **p_al = &alist->data;
+    allocate_function alloc;
+    const item_type *itype;
+    allocation *al, *aend;
+
+    if (alist->size == 0)
+      continue;
+    alloc = get_allocator(rtype);
+    itype = resource2item(rtype);
+    aend = alist->data + alist->size;
 
     freset(r, RF_SELECT);
-    alloc(rtype, r, alist->data);
+    alloc(rtype, r, alist->data, alist->size);
 
-    while (*p_al) {
-      allocation *al = *p_al;
+    for (al = alist->data; al != aend; ++al) {
       if (al->get) {
         assert(itype || !"not implemented for non-items");
         i_change(&al->unit->items, itype, al->get);
@@ -1771,13 +1814,20 @@ void split_allocations(region * r)
       ADDMSG(&al->unit->faction->msgs, msg_message("produce",
           "unit region amount wanted resource",
           al->unit, al->unit->region, al->get, al->want, rtype));
-      *p_al = al->next;
-      free_allocation(al);
     }
-    *p_alist = alist->next;
+    alist->size = 0;
+  }
+}
+
+/* the lists point to resource types, they must not outlive the game data */
+void free_allocations(void)
+{
+  while (allocations) {
+    allocation_list *alist = allocations;
+    allocations = alist->next;
+    free(alist->data);
     free(alist);
   }
-  allocations = NULL;
 }
 
 static void create_potion(unit * u, const potion_type * ptype, int want)
@@ -1984,8 +2034,9 @@ static void expandbuying(region * r, request * buyorders)
     int multi;
   } *trades, *trade;
   static int ntrades = 0;
-  int i, j;
+  int i;
   const luxury_type *ltype;
+  request *o;
 
   if (ntrades == 0) {
     for (ltype = luxurytypes; ltype; ltype = ltype->next)
@@ -2011,25 +2062,25 @@ static void expandbuying(region * r, request * buyorders)
   max_products = rpeasants(r) / TRADE_FRACTION;
 
   /* Kauf - auch so programmiert, da er leicht erweiterbar auf mehrere
-   * Gter pro Monat ist. j sind die Befehle, i der Index des
+   * Gter pro Monat ist. o ist der gezogene Befehl, i der Index des
    * gehandelten Produktes. */
   if (max_products > 0) {
     expandorders(r, buyorders);
     if (!norders)
       return;
 
-    for (j = 0; j != norders; j++) {
+    while ((o = nextorder()) != NULL) {
       int price, multi;
-      ltype = oa[j].type.ltype;
+      ltype = o->type.ltype;
       trade = trades;
       while (trade->type != ltype)
         ++trade;
       multi = trade->multi;
       price = ltype->price * multi;
 
-      if (get_pooled(oa[j].unit, oldresourcetype[R_SILVER], GET_DEFAULT,
+      if (get_pooled(o->unit, oldresourcetype[R_SILVER], GET_DEFAULT,
           price) >= price) {
-        unit *u = oa[j].unit;
+        unit *u = o->unit;
         item *items;
 
         /* litems zhlt die Gter, die verkauft wurden, u->n das Geld, das
@@ -2043,7 +2094,7 @@ static void expandbuying(region * r, request * buyorders)
         items = a->data.v;
         i_change(&items, ltype->itype, 1);
         a->data.v = items;
-        i_change(&oa[j].unit->items, ltype->itype, 1);
+        i_change(&u->items, ltype->itype, 1);
         use_pooled(u, oldresourcetype[R_SILVER], GET_DEFAULT, price);
         if (u->n < 0)
           u->n = 0;
@@ -2059,9 +2110,12 @@ static void expandbuying(region * r, request * buyorders)
           ++trade->multi;
         }
         fset(u, UFL_LONGACTION | UFL_NOTMOVING);
+      } else {
+        /* Das Silber wird nicht mehr, der Preis nicht kleiner. */
+        droporder(o);
       }
     }
-    free(oa);
+    free_requests();
 
     /* Ausgabe an Einheiten */
 
@@ -2133,11 +2187,8 @@ static void buy(unit * u, request ** buyorders, struct order *ord)
   } else {
     /* ...oder in der Region mu es eine Burg geben. */
     building *b;
-    static const struct building_type *bt_castle;
-    if (!bt_castle)
-      bt_castle = bt_find("castle");
     for (b = r->buildings; b; b = b->next) {
-      if (b->type == bt_castle && b->size >= 2)
+      if (b->type == bt_get(BT_CASTLE) && b->size >= 2)
         break;
     }
     if (b == NULL) {
@@ -2196,7 +2247,8 @@ static int tax_per_size[7] = { 0, 6, 12, 18, 24, 30, 36 };
 
 static void expandselling(region * r, request * sellorders, int limit)
 {
-  int money, price, j, max_products;
+  int money, price, max_products;
+  request *o;
   /* int m, n = 0; */
   int maxsize = 0, maxeffsize = 0;
   int taxcollected = 0;
@@ -2226,17 +2278,17 @@ static void expandselling(region * r, request * sellorders, int limit)
 
   for (b = rbuildings(r); b; b = b->next) {
     if (b->size > maxsize && building_owner(b) != NULL
-      && b->type == bt_find("castle")) {
+      && b->type == bt_get(BT_CASTLE)) {
       maxb = b;
       maxsize = b->size;
       maxowner = building_owner(b);
-    } else if (b->size == maxsize && b->type == bt_find("castle")) {
+    } else if (b->size == maxsize && b->type == bt_get(BT_CASTLE)) {
       maxb = (building *) NULL;
       maxowner = (unit *) NULL;
     }
   }
 
-  hafenowner = owner_buildingtyp(r, bt_find("harbour"));
+  hafenowner = owner_buildingtyp(r, bt_get(BT_HARBOUR));
 
   if (maxb != (building *) NULL && maxowner != (unit *) NULL) {
     maxeffsize = buildingeffsize(maxb, false);
@@ -2258,7 +2310,7 @@ static void expandselling(region * r, request * sellorders, int limit)
     return;
 
   if (r->terrain == newterrain(T_DESERT)
-    && buildingtype_exists(r, bt_find("caravan"), true)) {
+    && buildingtype_exists(r, bt_get(BT_CARAVAN), true)) {
     max_products = rpeasants(r) * 2 / TRADE_FRACTION;
   }
   /* Verkauf: so programmiert, dass er leicht auf mehrere Gueter pro
@@ -2268,9 +2320,9 @@ static void expandselling(region * r, request * sellorders, int limit)
   if (!norders)
     return;
 
-  for (j = 0; j != norders; j++) {
+  while ((o = nextorder()) != NULL) {
     static const luxury_type *search = NULL;
-    const luxury_type *ltype = oa[j].type.ltype;
+    const luxury_type *ltype = o->type.ltype;
     int multi = r_demand(r, ltype);
     static int i = -1;
     int use = 0;
@@ -2279,8 +2331,13 @@ static void expandselling(region * r, request * sellorders, int limit)
       for (search = luxurytypes; search != ltype; search = search->next)
         ++i;
     }
-    if (counter[i] >= limit)
+    /* counter[i] und der Preis ndern sich erst mit dem nchsten Verkauf
+     * dieses Produkts, money wird nur weniger: was hier scheitert, scheitert
+     * auch spter. */
+    if (counter[i] >= limit) {
+      droporder(o);
       continue;
+    }
     if (counter[i] + 1 > max_products && multi > 1)
       --multi;
     price = ltype->price * multi;
@@ -2288,7 +2345,7 @@ static void expandselling(region * r, request * sellorders, int limit)
     if (money >= price) {
       int abgezogenhafen = 0;
       int abgezogensteuer = 0;
-      unit *u = oa[j].unit;
+      unit *u = o->unit;
       item *itm;
       attrib *a = a_find(u->attribs, &at_luxuries);
       if (a == NULL)
@@ -2334,18 +2391,20 @@ static void expandselling(region * r, request * sellorders, int limit)
         }
         counter[i] = 0;
       }
+    } else {
+      droporder(o);
     }
     if (use > 0) {
 #ifdef NDEBUG
-      use_pooled(oa[j].unit, ltype->itype->rtype, GET_DEFAULT, use);
+      use_pooled(o->unit, ltype->itype->rtype, GET_DEFAULT, use);
 #else
-      /* int i = */ use_pooled(oa[j].unit, ltype->itype->rtype, GET_DEFAULT,
+      /* int i = */ use_pooled(o->unit, ltype->itype->rtype, GET_DEFAULT,
         use);
       /* assert(i==use); */
 #endif
     }
   }
-  free(oa);
+  free_requests();
 
   /* Steuern. Hier werden die Steuern dem Besitzer der grten Burg gegeben. */
 
@@ -2407,7 +2466,7 @@ static bool sell(unit * u, request ** sellorders, struct order *ord)
     unlimited = false;
     n = rpeasants(r) / TRADE_FRACTION;
     if (r->terrain == newterrain(T_DESERT)
-      && buildingtype_exists(r, bt_find("caravan"), true))
+      && buildingtype_exists(r, bt_get(BT_CARAVAN), true))
       n *= 2;
     if (n == 0) {
       cmistake(u, ord, 303, MSG_COMMERCE);
@@ -2437,11 +2496,8 @@ static bool sell(unit * u, request ** sellorders, struct order *ord)
   } else {
     /* ...oder in der Region mu es eine Burg geben. */
     building *b;
-    static const struct building_type *bt_castle;
-    if (!bt_castle)
-      bt_castle = bt_find("castle");
     for (b = r->buildings; b; b = b->next) {
-      if (b->type == bt_castle && b->size >= 2)
+      if (b->type == bt_get(BT_CASTLE) && b->size >= 2)
         break;
     }
     if (b == NULL) {
@@ -2528,7 +2584,7 @@ static bool sell(unit * u, request ** sellorders, struct order *ord)
 
 static void expandstealing(region * r, request * stealorders)
 {
-  int i;
+  request *o;
 
   expandorders(r, stealorders);
   if (!norders)
@@ -2537,20 +2593,20 @@ static void expandstealing(region * r, request * stealorders)
   /* Fr jede unit in der Region wird Geld geklaut, wenn sie Opfer eines
    * Beklauen-Orders ist. Jedes Opfer mu einzeln behandelt werden.
    *
-   * u ist die beklaute unit. oa.unit ist die klauende unit.
+   * u ist die beklaute unit. o->unit ist die klauende unit.
    */
 
-  for (i = 0; i != norders && oa[i].unit->n <= oa[i].unit->wants; i++) {
-    unit *u = findunitg(oa[i].no, r);
+  while ((o = nextorder()) != NULL && o->unit->n <= o->unit->wants) {
+    unit *u = findunitg(o->no, r);
     int n = 0;
     if (u && u->region == r) {
       n = get_pooled(u, r_silver, GET_ALL, INT_MAX);
     }
 #ifndef GOBLINKILL
-    if (oa[i].type.goblin) {    /* Goblin-Spezialklau */
+    if (o->type.goblin) {       /* Goblin-Spezialklau */
       int uct = 0;
       unit *u2;
-      assert(effskill(oa[i].unit, SK_STEALTH) >= 4
+      assert(effskill(o->unit, SK_STEALTH) >= 4
         || !"this goblin\'s skill is too low");
       for (u2 = r->units; u2; u2 = u2->next) {
         if (u2->faction == u->faction) {
@@ -2565,17 +2621,17 @@ static void expandstealing(region * r, request * stealorders)
       n = 10;
     }
     if (n > 0) {
-      n = MIN(n, oa[i].unit->wants);
+      n = MIN(n, o->unit->wants);
       use_pooled(u, r_silver, GET_ALL, n);
-      oa[i].unit->n = n;
-      change_money(oa[i].unit, n);
+      o->unit->n = n;
+      change_money(o->unit, n);
       ADDMSG(&u->faction->msgs, msg_message("stealeffect", "unit region amount",
           u, u->region, n));
     }
-    add_income(oa[i].unit, IC_STEAL, oa[i].unit->wants, oa[i].unit->n);
-    fset(oa[i].unit, UFL_LONGACTION | UFL_NOTMOVING);
+    add_income(o->unit, IC_STEAL, o->unit->wants, o->unit->n);
+    fset(o->unit, UFL_LONGACTION | UFL_NOTMOVING);
   }
-  free(oa);
+  free_requests();
 }
 
 /* ------------------------------------------------------------- */
@@ -2766,7 +2822,7 @@ static void breedhorses(region * r, unit * u)
   struct building *b = inside_building(u);
   const struct building_type *btype = b ? b->type : NULL;
 
-  if (btype != bt_find("stables")) {
+  if (btype != bt_get(BT_STABLES)) {
     cmistake(u, u->thisorder, 122, MSG_PRODUCE);
     return;
   }
@@ -3204,18 +3260,26 @@ static int do_work(unit * u, order * ord, request * o)
 static void expandtax(region * r, request * taxorders)
 {
   unit *u;
-  int i;
+  int *counts, i, draws;
 
   expandorders(r, taxorders);
   if (!norders)
     return;
 
-  for (i = 0; i != norders && rmoney(r) > TAXFRACTION; i++) {
-    change_money(oa[i].unit, TAXFRACTION);
-    oa[i].unit->n += TAXFRACTION;
-    rsetmoney(r, rmoney(r) - TAXFRACTION);
+  /* Jede Ziehung bringt TAXFRACTION, solange die Region mehr als das hat.
+   * Wie viele Ziehungen es gibt, steht also vorher fest. */
+  draws = (rmoney(r) > TAXFRACTION) ? (rmoney(r) - 1) / TAXFRACTION : 0;
+  counts = splitorders(draws);
+  for (i = 0; i != odist.size; ++i) {
+    if (counts[i] > 0) {
+      int n = counts[i] * TAXFRACTION;
+      change_money(oa[i].unit, n);
+      oa[i].unit->n += n;
+      rsetmoney(r, rmoney(r) - n);
+    }
   }
-  free(oa);
+  free(counts);
+  free_requests();
 
   for (u = r->units; u; u = u->next) {
     if (u->n >= 0) {
@@ -3496,7 +3560,7 @@ void produce(struct region *r)
   if (sellorders) {
     int limit = rpeasants(r) / TRADE_FRACTION;
     if (r->terrain == newterrain(T_DESERT)
-      && buildingtype_exists(r, bt_find("caravan"), true))
+      && buildingtype_exists(r, bt_get(BT_CARAVAN), true))
       limit *= 2;
     expandselling(r, sellorders, limited ? limit : INT_MAX);
   }
@@ -53,6 +53,7 @@ extern "C" {
     struct region *r);
   extern int make_cmd(struct unit *u, struct order *ord);
   extern void split_allocations(struct region *r);
+  extern void free_allocations(void);
   extern int recruit_archetypes(void);
   extern int give_control_cmd(struct unit *u, struct order *ord);
   extern void give_control(struct unit * u, struct unit * u2);
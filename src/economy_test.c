@@ -2,6 +2,10 @@
 #include <kernel/types.h>
 #include "economy.h"
 
+#include <kernel/faction.h>
+#include <kernel/item.h>
+#include <kernel/order.h>
+#include <kernel/skill.h>
 #include <kernel/unit.h>
 #include <kernel/region.h>
 #include <kernel/building.h>
@@ -52,10 +56,48 @@ static void test_give_control_ship(CuTest * tc)
   CuAssertPtrEquals(tc, u2, ship_owner(sh));
 }
 
+/* a wealthy region: a thousand tax collectors ask for twenty times what
+ * the region has. expandorders() used to make one request for every ten
+ * silver of that. */
+static void test_tax_wealthy_region(CuTest * tc)
+{
+  struct faction *f;
+  region *r;
+  unit *u;
+  int i, total = 0;
+
+  test_cleanup();
+  test_create_locale();
+  test_create_world();
+  skill_enabled[SK_TAXING] = true;
+  skill_enabled[SK_WEAPONLESS] = true;
+  r = findregion(0, 0);
+  rsetpeasants(r, 0);
+  rsetmoney(r, 1000001);
+  f = test_create_faction(0);
+  for (i = 0; i != 1000; ++i) {
+    u = test_create_unit(f, r);
+    scale_number(u, 100);
+    set_level(u, SK_TAXING, 10);
+    set_level(u, SK_WEAPONLESS, 1);
+    u->thisorder = create_order(K_TAX, f->locale, NULL);
+  }
+  produce(r);
+  CuAssertIntEquals(tc, 1, rmoney(r));
+  for (u = r->units; u; u = u->next) {
+    int money = get_money(u);
+    CuAssertIntEquals(tc, 0, money % 10);
+    CuAssertTrue(tc, money <= 20000);
+    total += money;
+  }
+  CuAssertIntEquals(tc, 1000000, total);
+}
+
 CuSuite *get_economy_suite(void)
 {
   CuSuite *suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_give_control_building);
   SUITE_ADD_TEST(suite, test_give_control_ship);
+  SUITE_ADD_TEST(suite, test_tax_wealthy_region);
   return suite;
 }
@@ -25,6 +25,7 @@
 #include <items/itemtypes.h>
 #include <attributes/attributes.h>
 #include "archetype.h"
+#include "economy.h"
 #include "report.h"
 #include "items.h"
 #include "creport.h"
@@ -38,6 +39,7 @@ void game_done(void)
    * nicht freigegebenem Speicher sucht, der nicht bis zum Ende bentigt
    * wird (temporre Hilsstrukturen) */
 
+  free_allocations();
   free_game();
 
   creport_cleanup();
@@ -167,9 +167,9 @@ give_item(int want, const item_type * itype, unit * src, unit * dest,
         warden_add_give(src, dest, itype, r);
       }
 #endif
-      handle_event(dest->attribs, "receive", src);
+      handle_event_id(dest->attribs, EV_RECEIVE, src);
     }
-    handle_event(src->attribs, "give", dest);
+    handle_event_id(src->attribs, EV_GIVE, dest);
   }
   add_give(src, dest, n, r, item2resource(itype), ord, error);
   if (error)
@@ -279,6 +279,7 @@ void give_men(int n, unit * u, unit * u2, struct order *ord)
       set_racename(&u2->attribs, get_racename(u->attribs));
       u_setrace(u2, u_race(u));
       u2->irace = u->irace;
+      /* u2 is empty, so this does not change the faction's hero count */
       if (fval(u, UFL_HERO))
         fset(u2, UFL_HERO);
       else
@@ -39,9 +39,7 @@ use_studypotion(struct unit *u, const struct item_type *itype, int amount,
     skill_t sk;
     skill *sv;
 
-    init_tokens(u->thisorder);
-    skip_token();
-    sk = findskill(getstrtoken(), u->faction->locale);
+    sk = get_order_skill(u->thisorder);
     sv = get_skill(u, sk);
 
     if (sv && sv->level > 2) {
@@ -180,7 +178,7 @@ use_instantartsculpture(struct unit *u, const struct item_type *itype,
     return -1;
   }
 
-  b = new_building(bt_find("artsculpture"), u->region, u->faction->locale);
+  b = new_building(bt_get(BT_ARTSCULPTURE), u->region, u->faction->locale);
   b->size = 100;
 
   ADDMSG(&u->region->msgs, msg_message("artsculpture_create", "unit region",
@@ -202,7 +200,7 @@ use_instantartacademy(struct unit *u, const struct item_type *itype,
     return -1;
   }
 
-  b = new_building(bt_find("artacademy"), u->region, u->faction->locale);
+  b = new_building(bt_get(BT_ARTACADEMY), u->region, u->faction->locale);
   b->size = 100;
 
   ADDMSG(&u->region->msgs, msg_message("artacademy_create", "unit region", u,
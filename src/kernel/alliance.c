@@ -404,7 +404,7 @@ const char *alliancename(const alliance * al)
 
 void alliancevictory(void)
 {
-  const struct building_type *btype = bt_find("stronghold");
+  const struct building_type *btype = bt_get(BT_STRONGHOLD);
   region *r = regions;
   alliance *al = alliances;
   if (btype == NULL)
@@ -277,18 +277,14 @@ void build_road(region * r, unit * u, int size, direction_t d)
 
   if (r->terrain == newterrain(T_SWAMP)) {
     /* wenn kein Damm existiert */
-    static const struct building_type *bt_dam;
-    if (!bt_dam)
-      bt_dam = bt_find("dam");
+    const struct building_type *bt_dam = bt_get(BT_DAM);
     assert(bt_dam);
     if (!buildingtype_exists(r, bt_dam, true)) {
       cmistake(u, u->thisorder, 132, MSG_PRODUCE);
       return;
     }
   } else if (r->terrain == newterrain(T_DESERT)) {
-    static const struct building_type *bt_caravan;
-    if (!bt_caravan)
-      bt_caravan = bt_find("caravan");
+    const struct building_type *bt_caravan = bt_get(BT_CARAVAN);
     assert(bt_caravan);
     /* wenn keine Karawanserei existiert */
     if (!buildingtype_exists(r, bt_caravan, true)) {
@@ -296,9 +292,7 @@ void build_road(region * r, unit * u, int size, direction_t d)
       return;
     }
   } else if (r->terrain == newterrain(T_GLACIER)) {
-    static const struct building_type *bt_tunnel;
-    if (!bt_tunnel)
-      bt_tunnel = bt_find("tunnel");
+    const struct building_type *bt_tunnel = bt_get(BT_TUNNEL);
     assert(bt_tunnel);
     /* wenn kein Tunnel existiert */
     if (!buildingtype_exists(r, bt_tunnel, true)) {
@@ -787,7 +781,7 @@ build_building(unit * u, const building_type * btype, int want, order * ord)
       assert(building_owner(b)==u);
     }
 #ifdef WDW_PYRAMID
-    if (b->type == bt_find("pyramid") && f_get_alliance(u->faction) != NULL) {
+    if (b->type == bt_get(BT_PYRAMID) && f_get_alliance(u->faction) != NULL) {
       attrib *a = a_add(&b->attribs, a_new(&at_alliance));
       a->data.i = u->faction->alliance->id;
     }
@@ -146,11 +146,51 @@ building_type *bt_find(const char *name)
   return NULL;
 }
 
+static const char *buildingnames[MAXBUILDINGTYPES] = {
+  "castle",
+  "lighthouse",
+  "harbour",
+  "caravan",
+  "dam",
+  "tunnel",
+  "academy",
+  "artacademy",
+  "stables",
+  "inn",
+  "pyramid",
+  "stonecircle",
+  "blessedstonecircle",
+  "illusioncastle",
+  "artsculpture",
+  "market",
+  "stronghold",
+  "generic"
+};
+
+static const building_type *oldbuildingtypes[MAXBUILDINGTYPES];
+
+/* Returns the well-known building type bt without a name lookup,
+ * or NULL if it was never registered. Like bt_find, the first type
+ * registered under a name wins. */
+const building_type *bt_get(building_t bt)
+{
+  assert(bt >= 0 && bt < MAXBUILDINGTYPES);
+  return oldbuildingtypes[bt];
+}
+
 void bt_register(building_type * type)
 {
+  int i;
+
   if (type->init) {
     type->init(type);
   }
+  for (i = 0; i != MAXBUILDINGTYPES; ++i) {
+    if (!oldbuildingtypes[i] && strcmp(type->_name, buildingnames[i]) == 0) {
+      oldbuildingtypes[i] = type;
+      break;
+    }
+  }
   ql_push(&buildingtypes, (void *)type);
 }
 
@@ -182,15 +222,8 @@ const char *buildingtype(const building_type * btype, const building * b,
   int bsize)
 {
   const char *s = NULL;
-  static bool init_generic = false;
-  static const struct building_type *bt_generic;
-
-  if (!init_generic) {
-    init_generic = true;
-    bt_generic = bt_find("generic");
-  }
 
-  if (btype == bt_generic) {
+  if (btype == bt_get(BT_GENERIC)) {
     const attrib *a = a_find(b->attribs, &at_building_generic_type);
     if (a)
       s = (const char *)a->data.v;
@@ -453,16 +486,9 @@ building *new_building(const struct building_type * btype, region * r,
 {
   building **bptr = &r->buildings;
   building *b = (building *) calloc(1, sizeof(building));
-  static bool init_lighthouse = false;
-  static const struct building_type *bt_lighthouse = 0;
   const char *bname = 0;
   char buffer[32];
 
-  if (!init_lighthouse) {
-    bt_lighthouse = bt_find("lighthouse");
-    init_lighthouse = true;
-  }
-
   b->flags = BLD_WORKING | BLD_MAINTAINED;
   b->no = newcontainerid();
   bhash(b);
@@ -473,7 +499,7 @@ building *new_building(const struct building_type * btype, region * r,
     bptr = &(*bptr)->next;
   *bptr = b;
 
-  if (b->type == bt_lighthouse) {
+  if (b->type == bt_get(BT_LIGHTHOUSE)) {
     r->flags |= RF_LIGHTHOUSE;
   }
   if (b->type->name) {
@@ -502,19 +528,10 @@ static building *deleted_buildings;
 void remove_building(building ** blist, building * b)
 {
   unit *u;
-  static const struct building_type *bt_caravan, *bt_dam, *bt_tunnel;
-  static bool init = false;
-
-  if (!init) {
-    init = true;
-    bt_caravan = bt_find("caravan");
-    bt_dam = bt_find("dam");
-    bt_tunnel = bt_find("tunnel");
-  }
 
   assert(bfindhash(b->no));
 
-  handle_event(b->attribs, "destroy", b);
+  handle_event_id(b->attribs, EV_DESTROY, b);
   for (u = b->region->units; u; u = u->next) {
     if (u->building == b)
       leave(u, true);
@@ -526,7 +543,8 @@ void remove_building(building ** blist, building * b)
 
   /* Falls Karawanserei, Damm oder Tunnel einstrzen, wird die schon
    * gebaute Strae zur Hlfte vernichtet */
-  if (b->type == bt_caravan || b->type == bt_dam || b->type == bt_tunnel) {
+  if (b->type == bt_get(BT_CARAVAN) || b->type == bt_get(BT_DAM)
+    || b->type == bt_get(BT_TUNNEL)) {
     region *r = b->region;
     int d;
     for (d = 0; d != MAXDIRECTIONS; ++d) {
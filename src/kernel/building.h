@@ -73,7 +73,31 @@ extern "C" {
 
   extern struct quicklist *buildingtypes;
 
+  /* building types that the game code uses by name, see bt_get() */
+  typedef enum {
+    BT_CASTLE,
+    BT_LIGHTHOUSE,
+    BT_HARBOUR,
+    BT_CARAVAN,
+    BT_DAM,
+    BT_TUNNEL,
+    BT_ACADEMY,
+    BT_ARTACADEMY,
+    BT_STABLES,
+    BT_INN,
+    BT_PYRAMID,
+    BT_STONECIRCLE,
+    BT_BLESSEDSTONECIRCLE,
+    BT_ILLUSIONCASTLE,
+    BT_ARTSCULPTURE,
+    BT_MARKET,
+    BT_STRONGHOLD,
+    BT_GENERIC,
+    MAXBUILDINGTYPES
+  } building_t;
+
   extern building_type *bt_find(const char *name);
+  extern const building_type *bt_get(building_t bt);
   extern void register_buildings(void);
   extern void bt_register(struct building_type *type);
   extern int bt_effsize(const struct building_type *btype,
@@ -25,6 +25,26 @@ static void test_register_building(CuTest * tc)
   CuAssertPtrNotNull(tc, bt_find("herp"));
 }
 
+static void test_bt_get(CuTest * tc)
+{
+  building_type *btype;
+
+  test_cleanup();
+  test_create_locale();
+  test_create_buildingtype("harbour");
+  CuAssertPtrNotNull(tc, bt_get(BT_HARBOUR));
+  CuAssertPtrEquals(tc, bt_find("harbour"), (void *)bt_get(BT_HARBOUR));
+
+  /* a second type with the same name does not replace the first */
+  btype = test_create_buildingtype("harbour");
+  CuAssertTrue(tc, btype != bt_get(BT_HARBOUR));
+  CuAssertPtrEquals(tc, bt_find("harbour"), (void *)bt_get(BT_HARBOUR));
+
+  CuAssertPtrEquals(tc, 0, (void *)bt_get(BT_GENERIC));
+  btype = test_create_buildingtype("generic");
+  CuAssertPtrEquals(tc, btype, (void *)bt_get(BT_GENERIC));
+}
+
 static void test_building_set_owner(CuTest * tc)
 {
   struct region *r;
@@ -350,6 +370,7 @@ CuSuite *get_building_suite(void)
 {
   CuSuite *suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_register_building);
+  SUITE_ADD_TEST(suite, test_bt_get);
   SUITE_ADD_TEST(suite, test_building_set_owner);
   SUITE_ADD_TEST(suite, test_buildingowner_resets_when_empty);
   SUITE_ADD_TEST(suite, test_buildingowner_goes_to_next_when_empty);
@@ -55,7 +55,6 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include <util/attrib.h>
 #include <util/base36.h>
 #include <util/bsdstring.h>
-#include <critbit.h>
 #include <util/crmessage.h>
 #include <util/event.h>
 #include <util/functions.h>
@@ -578,19 +577,43 @@ int skill_limit(faction * f, skill_t sk)
   return m;
 }
 
+/** number of people in the faction who know the skill.
+ * The counts are kept in f->skillcount, and are updated by everything that
+ * changes the level of a skill or the size of a unit. Code that cannot do
+ * that calls skillcount_reset, and they are counted again on the next call.
+ */
 int count_skill(faction * f, skill_t sk)
 {
-  int n = 0;
-  unit *u;
+  if (!f->skillcount_valid) {
+    unit *u;
 
-  for (u = f->units; u; u = u->nextF) {
-    if (has_skill(u, sk)) {
-      if (!is_familiar(u)) {
-        n += u->number;
+    memset(f->skillcount, 0, sizeof(f->skillcount));
+    f->skillcount_valid = true;
+    for (u = f->units; u; u = u->nextF) {
+      const skill *sv;
+      for (sv = u->skills; sv != u->skills + u->skill_size; ++sv) {
+        skillcount_change(u, sv, u->number);
       }
     }
   }
-  return n;
+  return f->skillcount[sk];
+}
+
+/** add number people with the skill sv to the counts of u's faction.
+ * Call with -u->number before and u->number after changing sv->level. */
+void skillcount_change(const unit * u, const skill * sv, int number)
+{
+  faction *f = u->faction;
+  if (f && f->skillcount_valid && number && sv->level > 0 && !is_familiar(u)) {
+    f->skillcount[sv->id] += number;
+  }
+}
+
+void skillcount_reset(faction * f)
+{
+  if (f) {
+    f->skillcount_valid = false;
+  }
 }
 
 int verbosity = 1;
@@ -1144,15 +1167,10 @@ static attrib_type at_lighthouse = {
  */
 void update_lighthouse(building * lh)
 {
-  static bool init_lighthouse = false;
-  static const struct building_type *bt_lighthouse = 0;
+  const struct building_type *bt_lighthouse = bt_get(BT_LIGHTHOUSE);
 
-  if (!init_lighthouse) {
-    bt_lighthouse = bt_find("lighthouse");
-    if (bt_lighthouse == NULL)
-      return;
-    init_lighthouse = true;
-  }
+  if (bt_lighthouse == NULL)
+    return;
 
   if (lh->type == bt_lighthouse) {
     region *r = lh->region;
@@ -1193,38 +1211,16 @@ void update_lighthouse(building * lh)
   }
 }
 
+/* these counters are kept up to date by set_number, see
+ * update_faction_counts and verify_faction_counts */
 int count_all(const faction * f)
 {
-#ifndef NDEBUG
-  int n = 0;
-  unit *u;
-  for (u = f->units; u; u = u->nextF) {
-    if (playerrace(u_race(u))) {
-      n += u->number;
-      assert(f == u->faction);
-    }
-  }
-  if (f->num_people != n) {
-    log_error("# of people in %s is != num_people: %d should be %d.\n", factionid(f), f->num_people, n);
-  }
-#endif
   return f->num_people;
 }
 
 int count_migrants(const faction * f)
 {
-  unit *u = f->units;
-  int n = 0;
-  while (u) {
-    assert(u->faction == f);
-    if (u_race(u) != f->race && u_race(u) != new_race[RC_ILLUSION]
-      && u_race(u) != new_race[RC_SPELL]
-      && !!playerrace(u_race(u)) && !(is_cursed(u->attribs, C_SLAVE, 0))) {
-      n += u->number;
-    }
-    u = u->nextF;
-  }
-  return n;
+  return f->num_migrants;
 }
 
 int count_maxmigrants(const faction * f)
@@ -1324,65 +1320,52 @@ int findoption(const char *s, const struct locale *lang)
 
 skill_t findskill(const char *s, const struct locale * lang)
 {
-  param_t result = NOSKILL;
-  char buffer[64];
-  char * str = transliterate(buffer, sizeof(buffer)-sizeof(int), s);
-
-  if (str) {
-    int i;
-    const void * match;
-    void **tokens = get_translations(lang, UT_SKILLS);
-    critbit_tree *cb = (critbit_tree *)*tokens;
-    if (cb_find_prefix(cb, str, strlen(str), &match, 1, 0)) {
-      cb_get_kv(match, &i, sizeof(int));
-      result = (skill_t)i;
-    }
+  void **tokens = get_translations(lang, UT_SKILLS);
+  int i;
+
+  if (findprefix(*tokens, s, &i) == E_TOK_SUCCESS) {
+    return (skill_t)i;
+  }
+  return NOSKILL;
+}
+
+/** returns the name of a keyword in the given locale.
+ * The translation key is interned on first use, so this does not hash it.
+ */
+const char *keyword_name(keyword_t kwd, const struct locale *lang)
+{
+  static unsigned int ids[MAXKEYWORDS];
+
+  assert(kwd >= 0 && kwd < MAXKEYWORDS && keywords[kwd]);
+  if (!ids[kwd]) {
+    ids[kwd] = locale_key(keywords[kwd]);
   }
-  return result;
+  return locale_string_id(lang, ids[kwd]);
 }
 
 keyword_t findkeyword(const char *s, const struct locale * lang)
 {
-  keyword_t result = NOKEYWORD;
-  char buffer[64];
+  void **tokens = get_translations(lang, UT_KEYWORDS);
+  int i;
 
   while (*s == '@') ++s;
 
-  if (*s) {
-    char * str = transliterate(buffer, sizeof(buffer)-sizeof(int), s);
-
-    if (str) {
-      int i;
-      const void * match;
-      void **tokens = get_translations(lang, UT_KEYWORDS);
-      critbit_tree *cb = (critbit_tree *)*tokens;
-      if (cb_find_prefix(cb, str, strlen(str), &match, 1, 0)) {
-        cb_get_kv(match, &i, sizeof(int));
-        result = (keyword_t)i;
-        return global.disabled[result] ? NOKEYWORD : result;
-      }
-    }
+  if (findprefix(*tokens, s, &i) == E_TOK_SUCCESS) {
+    keyword_t result = (keyword_t)i;
+    return global.disabled[result] ? NOKEYWORD : result;
   }
   return NOKEYWORD;
 }
 
 param_t findparam(const char *s, const struct locale * lang)
 {
-  param_t result = NOPARAM;
-  char buffer[64];
-  char * str = transliterate(buffer, sizeof(buffer)-sizeof(int), s);
-
-  if (str && *str) {
-    int i;
-    const void * match;
-    void **tokens = get_translations(lang, UT_PARAMS);
-    critbit_tree *cb = (critbit_tree *)*tokens;
-    if (cb_find_prefix(cb, str, strlen(str), &match, 1, 0)) {
-      cb_get_kv(match, &i, sizeof(int));
-      result = (param_t)i;
-    }
+  void **tokens = get_translations(lang, UT_PARAMS);
+  int i;
+
+  if (findprefix(*tokens, s, &i) == E_TOK_SUCCESS) {
+    return (param_t)i;
   }
-  return result;
+  return NOPARAM;
 }
 
 param_t findparam_ex(const char *s, const struct locale * lang)
@@ -1770,7 +1753,7 @@ bool check_leuchtturm(region * r, faction * f)
     a = a->next) {
     building *b = (building *) a->data.v;
 
-    assert(b->type == bt_find("lighthouse"));
+    assert(b->type == bt_get(BT_LIGHTHOUSE));
     if (fval(b, BLD_WORKING) && b->size >= 10) {
       int maxd = (int)log10(b->size) + 1;
 
@@ -1954,7 +1937,7 @@ direction_t getdirection(const struct locale * lang)
 
 static void init_translations(const struct locale *lang, int ut, const char * (*string_cb)(int i), int maxstrings)
 {
-  char buffer[256];
+  char buffer[PREFIX_MAXLEN];
   void **tokens;
   int i;
 
@@ -1965,15 +1948,9 @@ static void init_translations(const struct locale *lang, int ut, const char * (*
     const char * s = string_cb(i);
     const char * key = s ? locale_string(lang, s) : 0;
     if (key) {
-      char * str = transliterate(buffer, sizeof(buffer)-sizeof(int), key);
+      char * str = transliterate(buffer, sizeof(buffer), key);
       if (str) {
-        critbit_tree * cb = (critbit_tree *)*tokens;
-		size_t len = strlen(str);
-		if (!cb) {
-          *tokens = cb = (critbit_tree *)calloc(1, sizeof(critbit_tree *));
-        }
-        len = cb_new_kv(str, len, &i, sizeof(int), buffer);
-        cb_insert(cb, buffer, len);
+        addprefix(tokens, str, i);
       } else {
         log_error("could not transliterate '%s'\n", key);
       }
@@ -2522,7 +2499,6 @@ bool hunger(int number, unit * u)
 void plagues(region * r, bool ismagic)
 {
   int peasants;
-  int i;
   int dead = 0;
 
   /* Seuchenwahrscheinlichkeit in % */
@@ -2539,10 +2515,14 @@ void plagues(region * r, bool ismagic)
 
   peasants = rpeasants(r);
   dead = (int)(0.5F + PLAGUE_VICTIMS * peasants);
-  for (i = dead; i != 0; i--) {
-    if (rng_double() < PLAGUE_HEALCHANCE && rmoney(r) >= PLAGUE_HEALCOST) {
-      rsetmoney(r, rmoney(r) - PLAGUE_HEALCOST);
-      --dead;
+  if (dead > 0) {
+    /* jeder Kranke wird mit PLAGUE_HEALCHANCE geheilt, solange das Geld
+     * reicht */
+    int healed = MIN(binomialvariate(dead, PLAGUE_HEALCHANCE),
+      rmoney(r) / PLAGUE_HEALCOST);
+    if (healed > 0) {
+      rsetmoney(r, rmoney(r) - healed * PLAGUE_HEALCOST);
+      dead -= healed;
     }
   }
 
@@ -2569,10 +2549,7 @@ static const int wagetable[7][4] = {
 
 int cmp_wage(const struct building *b, const building * a)
 {
-  static const struct building_type *bt_castle;
-  if (!bt_castle)
-    bt_castle = bt_find("castle");
-  if (b->type == bt_castle) {
+  if (b->type == bt_get(BT_CASTLE)) {
     if (!a)
       return 1;
     if (b->size > a->size)
@@ -2751,7 +2728,7 @@ default_wage(const region * r, const faction * f, const race * rc, int in_turn)
   curse *c;
   double wage;
   attrib *a;
-  const building_type *artsculpture_type = bt_find("artsculpture");
+  const building_type *artsculpture_type = bt_get(BT_ARTSCULPTURE);
   static const curse_type *drought_ct, *blessedharvest_ct;
   static bool init;
 
@@ -3111,6 +3088,12 @@ void free_gamedata(void)
   while (global.attribs) {
     a_remove(&global.attribs, global.attribs);
   }
+  /* no handlers are left that could refer to the names */
+  free_events();
+  /* return the blocks that no longer hold any objects */
+  i_freeblocks();
+  free_orderblocks();
+  a_freeblocks();
   ++global.cookie;              /* readgame() already does this, but sjust in case */
 }
 
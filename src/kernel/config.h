@@ -141,6 +141,9 @@ extern "C" {
 /* skills */
   extern int skill_limit(struct faction *f, skill_t sk);
   extern int count_skill(struct faction *f, skill_t sk);
+  extern void skillcount_change(const struct unit *u, const struct skill *sv,
+    int number);
+  extern void skillcount_reset(struct faction *f);
 
 /* direction, geography */
   extern const char *directions[];
@@ -166,6 +169,7 @@ extern "C" {
   extern skill_t findskill(const char *s, const struct locale *lang);
 
   extern keyword_t findkeyword(const char *s, const struct locale *lang);
+  extern const char *keyword_name(keyword_t kwd, const struct locale *lang);
 
   param_t findparam(const char *s, const struct locale *lang);
   param_t findparam_ex(const char *s, const struct locale * lang);
@@ -115,9 +115,34 @@ static connection **get_borders_i(const region * r1, const region * r2)
   return bp;
 }
 
+#ifdef FAST_CONNECT
+/* regions that know each other as neighbours keep the first connection
+ * between them in region::borders, so it can be found without the hash */
+static void set_borders(region * r1, region * r2, connection * b)
+{
+  int d;
+  for (d = 0; d != MAXDIRECTIONS; ++d) {
+    if (r1->connect[d] == r2)
+      r1->borders[d] = b;
+    if (r2->connect[d] == r1)
+      r2->borders[d] = b;
+  }
+}
+#else
+# define set_borders(r1, r2, b)
+#endif
+
 connection *get_borders(const region * r1, const region * r2)
 {
-  connection **bp = get_borders_i(r1, r2);
+  connection **bp;
+#ifdef FAST_CONNECT
+  int d;
+  for (d = 0; d != MAXDIRECTIONS; ++d) {
+    if (r1->connect[d] == r2)
+      return r1->borders[d];
+  }
+#endif
+  bp = get_borders_i(r1, r2);
   return *bp;
 }
 
@@ -127,6 +152,9 @@ connection *new_border(border_type * type, region * from, region * to)
 
   if (from && to) {
     connection **bp = get_borders_i(from, to);
+    if (*bp == NULL) {
+      set_borders(from, to, b);
+    }
     while (*bp)
       bp = &(*bp)->next;
     *bp = b;
@@ -154,6 +182,7 @@ void erase_border(connection * b)
       } else {
         *bp = b->nexthash;
       }
+      set_borders(b->from, b->to, b->next);
     } else {
       while (*bp && *bp != b) {
         bp = &(*bp)->next;
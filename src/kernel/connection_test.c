@@ -0,0 +1,86 @@
+#include <platform.h>
+#include <kernel/types.h>
+#include "connection.h"
+#include "region.h"
+
+#include <CuTest.h>
+#include <tests.h>
+
+static border_type bt_test = {
+  "test", VAR_INT
+};
+
+static void test_borders_between_neighbours(CuTest * tc)
+{
+  region *r1, *r2;
+  connection *b1, *b2;
+
+  test_cleanup();
+  test_create_world();
+  r1 = findregion(0, 0);
+  r2 = findregion(1, 0);
+
+  b1 = new_border(&bt_test, r1, r2);
+  CuAssertPtrEquals(tc, r2, rconnect(r1, D_EAST));
+  CuAssertPtrEquals(tc, b1, get_borders(r1, r2));
+  CuAssertPtrEquals(tc, b1, get_borders(r2, r1));
+
+  b2 = new_border(&bt_test, r2, r1);
+  CuAssertPtrEquals(tc, b1, get_borders(r2, r1));
+  CuAssertPtrEquals(tc, b2, b1->next);
+  CuAssertPtrEquals(tc, b2, find_border(b2->id));
+
+  erase_border(b1);
+  CuAssertPtrEquals(tc, b2, get_borders(r1, r2));
+  CuAssertPtrEquals(tc, b2, get_borders(r2, r1));
+  erase_border(b2);
+  CuAssertPtrEquals(tc, 0, get_borders(r1, r2));
+  CuAssertPtrEquals(tc, 0, get_borders(r2, r1));
+}
+
+static void test_borders_before_connect(CuTest * tc)
+{
+  region *r1, *r2;
+  connection *b;
+
+  test_cleanup();
+  test_create_world();
+  r1 = test_create_region(5, 5, findregion(0, 0)->terrain);
+  r2 = test_create_region(6, 5, r1->terrain);
+
+  /* the regions do not know each other yet */
+  b = new_border(&bt_test, r1, r2);
+  CuAssertPtrEquals(tc, b, get_borders(r1, r2));
+  CuAssertPtrEquals(tc, r2, rconnect(r1, D_EAST));
+  CuAssertPtrEquals(tc, b, r1->borders[D_EAST]);
+  CuAssertPtrEquals(tc, b, r2->borders[D_WEST]);
+  erase_border(b);
+  CuAssertPtrEquals(tc, 0, get_borders(r2, r1));
+}
+
+static void test_borders_between_strangers(CuTest * tc)
+{
+  region *r1, *r2;
+  connection *b;
+
+  test_cleanup();
+  test_create_world();
+  r1 = findregion(0, 0);
+  r2 = test_create_region(5, 5, r1->terrain);
+
+  b = new_border(&bt_test, r1, r2);
+  CuAssertPtrEquals(tc, b, get_borders(r1, r2));
+  CuAssertPtrEquals(tc, b, get_borders(r2, r1));
+  CuAssertPtrEquals(tc, b, find_border(b->id));
+  erase_border(b);
+  CuAssertPtrEquals(tc, 0, get_borders(r1, r2));
+}
+
+CuSuite *get_connection_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_borders_between_neighbours);
+  SUITE_ADD_TEST(suite, test_borders_before_connect);
+  SUITE_ADD_TEST(suite, test_borders_between_strangers);
+  return suite;
+}
@@ -762,6 +762,18 @@ const char *oldcursename(int id)
   return oldnames[id];
 }
 
+/* curse types are never unregistered, so the name lookup is done once */
+const curse_type *oldcursetype(int id)
+{
+  static const curse_type *oldtypes[MAXCURSE];
+  const curse_type *ct = oldtypes[id];
+
+  if (!ct) {
+    ct = oldtypes[id] = ct_find(oldnames[id]);
+  }
+  return ct;
+}
+
 /* ------------------------------------------------------------- */
 message *cinfo_simple(const void *obj, objtype_t typ, const struct curse * c,
   int self)
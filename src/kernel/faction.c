@@ -344,7 +344,7 @@ void destroyfaction(faction * f)
   }
   f->alive = 0;
 /* no way!  f->units = NULL; */
-  handle_event(f->attribs, "destroy", f);
+  handle_event_id(f->attribs, EV_DESTROY, f);
   for (ff = factions; ff; ff = ff->next) {
     group *g;
     ally *sf, *sfn;
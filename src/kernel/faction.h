@@ -25,7 +25,7 @@ extern "C" {
   struct player;
   struct alliance;
   struct item;
-  struct seen_region;
+  struct seen_map;
 
 /* SMART_INTERVALS: define to speed up finding the interval of regions that a 
    faction is in. defining this speeds up the turn by 30-40% */
@@ -81,8 +81,12 @@ extern "C" {
     int newbies;
     int num_people;             /* Anzahl Personen ohne Monster */
     int num_total;              /* Anzahl Personen mit Monstern */
+    int num_migrants;           /* Anzahl Personen fremder Rassen */
+    int num_heroes;             /* Anzahl Helden */
     int options;
     int no_units;
+    int skillcount[MAXSKILLS];  /* cache for count_skill() */
+    bool skillcount_valid;
     struct ally *allies;
     struct group *groups;
     bool alive;              /* enno: sollte ein flag werden */
@@ -105,7 +109,7 @@ extern "C" {
       struct message_list *msgs;
     } *battles;
     struct item *items;         /* items this faction can claim */
-    struct seen_region **seen;
+    struct seen_map *seen;
     struct quicklist *seen_factions;
   } faction;
 
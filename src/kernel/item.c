@@ -42,6 +42,7 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 /* util includes */
 #include <util/attrib.h>
 #include <util/base36.h>
+#include <util/blockalloc.h>
 #include <critbit.h>
 #include <util/event.h>
 #include <util/functions.h>
@@ -174,6 +175,15 @@ resource_type *new_resourcetype(const char **names, const char **appearances,
   return rtype;
 }
 
+static int number_itype_cb(const void * match, const void * key, size_t keylen, void *cbdata)
+{
+  int *index = (int *)cbdata;
+  item_type *itype;
+  cb_get_kv(match, &itype, sizeof(itype));
+  itype->index = (*index)++;
+  return 0;
+}
+
 void it_register(item_type * itype)
 {
   char buffer[64];
@@ -183,6 +193,10 @@ void it_register(item_type * itype)
   assert(len<sizeof(buffer)-sizeof(itype));
   len = cb_new_kv(name, len, &itype, sizeof(itype), buffer);
   if (cb_insert(&cb_items, buffer, len)) {
+    int index = 0;
+    /* item lists are sorted by index. renumbering keeps the order of the
+     * existing types, so lists that already exist stay sorted. */
+    cb_foreach(&cb_items, "", 0, number_itype_cb, &index);
     rt_register(itype->rtype);
   }
 }
@@ -392,36 +406,43 @@ item_type *it_find(const char *zname)
   return result;
 }
 
+/* returns the slot that holds the item, or the empty slot at the end of
+ * the list if there is none. */
 item **i_find(item ** i, const item_type * it)
 {
-  while (*i && (*i)->type != it)
+  if (it) {
+    while (*i && (*i)->type->index < it->index)
+      i = &(*i)->next;
+    if (*i && (*i)->type == it)
+      return i;
+  }
+  while (*i)
     i = &(*i)->next;
   return i;
 }
 
 item *const *i_findc(item * const *i, const item_type * it)
 {
-  while (*i && (*i)->type != it) {
-    i = &(*i)->next;
-  }
-  return i;
+  return (item * const *)i_find((item **)i, it);
 }
 
+/* item lists are sorted by item_type::index, so the search can stop at
+ * the first larger one. */
 int i_get(const item * i, const item_type * it)
 {
-  i = *i_find((item **) & i, it);
-  if (i)
-    return i->number;
+  if (it) {
+    while (i && i->type->index < it->index)
+      i = i->next;
+    if (i && i->type == it)
+      return i->number;
+  }
   return 0;
 }
 
 item *i_add(item ** pi, item * i)
 {
   assert(i && i->type && !i->next);
-  while (*pi) {
-    int d = strcmp((*pi)->type->rtype->_name[0], i->type->rtype->_name[0]);
-    if (d >= 0)
-      break;
+  while (*pi && (*pi)->type->index < i->type->index) {
     pi = &(*pi)->next;
   }
   if (*pi && (*pi)->type == i->type) {
@@ -440,10 +461,7 @@ void i_merge(item ** pi, item ** si)
   item *i = *si;
   while (i) {
     item *itmp;
-    while (*pi) {
-      int d = strcmp((*pi)->type->rtype->_name[0], i->type->rtype->_name[0]);
-      if (d >= 0)
-        break;
+    while (*pi && (*pi)->type->index < i->type->index) {
       pi = &(*pi)->next;
     }
     if (*pi && (*pi)->type == i->type) {
@@ -463,10 +481,7 @@ void i_merge(item ** pi, item ** si)
 item *i_change(item ** pi, const item_type * itype, int delta)
 {
   assert(itype);
-  while (*pi) {
-    int d = strcmp((*pi)->type->rtype->_name[0], itype->rtype->_name[0]);
-    if (d >= 0)
-      break;
+  while (*pi && (*pi)->type->index < itype->index) {
     pi = &(*pi)->next;
   }
   if (!*pi || (*pi)->type != itype) {
@@ -506,19 +521,18 @@ item *i_remove(item ** pi, item * i)
   return i;
 }
 
-static item *icache;
-static int icache_size;
-#define ICACHE_MAX 100
+/* items are allocated in blocks, in the order they are created (readgame
+ * creates them region by region). freed items are kept for reuse. */
+static block_allocator icache = BLOCK_ALLOCATOR(item, 1024);
 
 void i_free(item * i)
 {
-  if (icache_size >= ICACHE_MAX) {
-    free(i);
-  } else {
-    i->next = icache;
-    icache = i;
-    ++icache_size;
-  }
+  ba_free(&icache, i);
+}
+
+void i_freeblocks(void)
+{
+  ba_release(&icache);
 }
 
 void i_freeall(item ** i)
@@ -534,14 +548,7 @@ void i_freeall(item ** i)
 
 item *i_new(const item_type * itype, int size)
 {
-  item *i;
-  if (icache_size > 0) {
-    i = icache;
-    icache = i->next;
-    --icache_size;
-  } else {
-    i = malloc(sizeof(item));
-  }
+  item *i = (item *)ba_alloc(&icache);
   assert(itype);
   i->next = NULL;
   i->type = itype;
@@ -605,11 +612,9 @@ const potion_type *oldpotiontype[MAXPOTIONS + 1];
 
 int get_item(const unit * u, item_t it)
 {
-  const item_type *type = olditemtype[it];
-  const item *i = *i_findc(&u->items, type);
-  if (i)
-    assert(i->number >= 0);
-  return i ? i->number : 0;
+  int n = i_get(u->items, olditemtype[it]);
+  assert(n >= 0);
+  return n;
 }
 
 int set_item(unit * u, item_t it, int value)
@@ -128,6 +128,7 @@ extern "C" {
     resource_type *rtype;
     /* --- constants --- */
     unsigned int flags;
+    int index;                  /* dense id, in the order of the names */
     int weight;
     int capacity;
     struct construction *construction;
@@ -245,6 +246,7 @@ extern "C" {
   extern item *i_remove(item ** pi, item * it);
   extern void i_free(item * i);
   extern void i_freeall(item ** i);
+  extern void i_freeblocks(void);
   extern item *i_new(const item_type * it, int number);
 
 /* convenience: */
@@ -106,6 +106,44 @@ void test_findresourcetype(CuTest * tc)
   CuAssertPtrNotNull(tc, findresourcetype("Bauer", lang));
 }
 
+static void test_item_list_sorted(CuTest * tc)
+{
+  const char *names[] = { "bb", "bb", "dd", "dd", "cc", "cc", "aa", "aa" };
+  item_type *ib, *id, *ic, *ia;
+  item *items = 0;
+
+  test_cleanup();
+  ib = test_create_itemtype(names + 0);
+  id = test_create_itemtype(names + 2);
+  i_change(&items, id, 4);
+  i_change(&items, ib, 2);
+  CuAssertPtrEquals(tc, ib, (void *)items->type);
+  CuAssertPtrEquals(tc, id, (void *)items->next->type);
+
+  /* new types keep existing lists in order */
+  ic = test_create_itemtype(names + 4);
+  ia = test_create_itemtype(names + 6);
+  CuAssertTrue(tc, ia->index < ib->index && ib->index < ic->index
+    && ic->index < id->index);
+  CuAssertPtrEquals(tc, 0, *i_find(&items, ic));
+  i_change(&items, ic, 3);
+  i_add(&items, i_new(ia, 1));
+  CuAssertIntEquals(tc, 1, i_get(items, ia));
+  CuAssertIntEquals(tc, 2, i_get(items, ib));
+  CuAssertIntEquals(tc, 3, i_get(items, ic));
+  CuAssertIntEquals(tc, 4, i_get(items, id));
+  CuAssertPtrEquals(tc, ia, (void *)items->type);
+  CuAssertPtrEquals(tc, id, (void *)items->next->next->next->type);
+
+  i_change(&items, ib, -2);
+  CuAssertIntEquals(tc, 0, i_get(items, ib));
+  CuAssertPtrEquals(tc, 0, *i_find(&items, ib));
+  /* a missing item gives the empty slot at the end of the list */
+  CuAssertPtrEquals(tc, &items->next->next->next, i_find(&items, ib));
+  CuAssertPtrEquals(tc, ic, (void *)(*i_find(&items, ic))->type);
+  i_freeall(&items);
+}
+
 CuSuite *get_item_suite(void)
 {
   CuSuite *suite = CuSuiteNew();
@@ -114,5 +152,6 @@ CuSuite *get_item_suite(void)
   SUITE_ADD_TEST(suite, test_resource_type);
   SUITE_ADD_TEST(suite, test_finditemtype);
   SUITE_ADD_TEST(suite, test_findresourcetype);
+  SUITE_ADD_TEST(suite, test_item_list_sorted);
   return suite;
 }
@@ -2177,6 +2177,7 @@ static void set_familiar(unit * mage, unit * familiar)
   if (a == NULL) {
     a = a_add(&familiar->attribs, a_new(&at_familiarmage));
     a->data.v = mage;
+    skillcount_reset(familiar->faction);
   } else
     assert(!a->data.v || a->data.v == mage);
 }
@@ -2213,6 +2214,7 @@ bool create_newfamiliar(unit * mage, unit * familiar)
   afam->data.v = familiar;
   if (amage == NULL) {
     amage = a_add(&familiar->attribs, a_new(&at_familiarmage));
+    skillcount_reset(familiar->faction);
   }
   amage->data.v = mage;
 
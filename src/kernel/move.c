@@ -627,10 +627,7 @@ static bool is_freezing(const unit * u)
 int check_ship_allowed(struct ship *sh, const region * r)
 {
   int c = 0;
-  static const building_type *bt_harbour = NULL;
-
-  if (bt_harbour == NULL)
-    bt_harbour = bt_find("harbour");
+  const building_type *bt_harbour = bt_get(BT_HARBOUR);
 
   if (sh->region && r_insectstalled(r)) {
     /* insekten drfen nicht hier rein. haben wir welche? */
@@ -1649,7 +1646,7 @@ static bool check_takeoff(ship * sh, region * from, region * to)
       (direction_t) ((coast + MAXDIRECTIONS - 1) % MAXDIRECTIONS);
 
     if (dir != coast && dir != coastl && dir != coastr
-      && !buildingtype_exists(from, bt_find("harbour"), true)) {
+      && !buildingtype_exists(from, bt_get(BT_HARBOUR), true)) {
       return false;
     }
   }
@@ -1912,7 +1909,7 @@ sail(unit * u, order * ord, bool move_on_land, region_list ** routep)
 
     /* Hafengebhren ? */
 
-    hafenmeister = owner_buildingtyp(current_point, bt_find("harbour"));
+    hafenmeister = owner_buildingtyp(current_point, bt_get(BT_HARBOUR));
     if (sh && hafenmeister != NULL) {
       item *itm;
       unit *u2;
@@ -17,7 +17,9 @@
 #include "skill.h"
 
 #include <util/base36.h>
+#include <util/blockalloc.h>
 #include <util/bsdstring.h>
+#include <util/goodies.h>
 #include <util/language.h>
 #include <util/log.h>
 #include <util/parser.h>
@@ -32,6 +34,7 @@
 # define ORD_KEYWORD(ord) (ord)->data->_keyword
 # define ORD_LOCALE(ord) locale_array[(ord)->data->_lindex]->lang
 # define ORD_STRING(ord) (ord)->data->_str
+# define ORD_PARAM(ord) (ord)->data->_param
 
 typedef struct locale_data {
   struct order_data *short_orders[MAXKEYWORDS];
@@ -39,20 +42,64 @@ typedef struct locale_data {
   const struct locale *lang;
 } locale_data;
 
-static struct locale_data *locale_array[16];
-static int nlocales = 0;
+static struct locale_data *locale_array[MAXLOCALES];
 
 typedef struct order_data {
   char *_str;
+  struct order_data *_nexthash;
+  unsigned int _hash;
   int _refcount:20;
   int _lindex:4;
   keyword_t _keyword;
+  /* das erste Argument, einmal beim Erzeugen geparst: */
+  param_t _param;
+  skill_t _skill;
 } order_data;
 
+/* Befehle mit Argumenten werden ueber Schluesselwort, Sprache und
+ * Argumenttext geteilt, damit die vielen Einheiten, die jede Runde
+ * dasselbe tun, sich ein order_data teilen. */
+static order_data **odata_hash;
+static unsigned int odata_size, odata_count;
+
+static unsigned int hash_data(keyword_t kwd, const char *s, int lindex)
+{
+  return (hashstring(s) * 31 + (unsigned int)kwd) * 16 + lindex;
+}
+
+static void rehash_data(void)
+{
+  unsigned int i, size = odata_size ? odata_size * 2 : 1024;
+  order_data **table = (order_data **)calloc(size, sizeof(order_data *));
+
+  for (i = 0; i != odata_size; ++i) {
+    order_data *data = odata_hash[i];
+    while (data) {
+      order_data *next = data->_nexthash;
+      order_data **bucket = table + data->_hash % size;
+      data->_nexthash = *bucket;
+      *bucket = data;
+      data = next;
+    }
+  }
+  free(odata_hash);
+  odata_hash = table;
+  odata_size = size;
+}
+
 static void release_data(order_data * data)
 {
   if (data) {
     if (--data->_refcount == 0) {
+      if (odata_size) {
+        order_data **dp = odata_hash + data->_hash % odata_size;
+        while (*dp && *dp != data)
+          dp = &(*dp)->_nexthash;
+        if (*dp) {
+          *dp = data->_nexthash;
+          --odata_count;
+        }
+      }
       if (data->_str)
         free(data->_str);
       free(data);
@@ -83,6 +130,27 @@ keyword_t get_keyword(const order * ord)
   return ORD_KEYWORD(ord);
 }
 
+/** returns the first argument of the order as a parameter, or NOPARAM.
+ * The argument is parsed once, when the order is created, so callers
+ * that only need to look at it don't have to tokenize the order again.
+ */
+param_t get_order_param(const order * ord)
+{
+  if (ord == NULL) {
+    return NOPARAM;
+  }
+  return ORD_PARAM(ord);
+}
+
+/** returns the skill named by a LERNE order, or NOSKILL. */
+skill_t get_order_skill(const order * ord)
+{
+  if (ord == NULL) {
+    return NOSKILL;
+  }
+  return ord->data->_skill;
+}
+
 /** returns a plain-text representation of the order.
  * This is the inverse function to the parse_order command. Note that
  * keywords are expanded to their full length.
@@ -107,7 +175,7 @@ static char *get_command(const order * ord, char *sbuffer, size_t size)
     if (size > 0) {
       if (text)
         --size;
-      bytes = (int)strlcpy(bufp, (const char *)LOC(lang, keywords[kwd]), size);
+      bytes = (int)strlcpy(bufp, keyword_name(kwd, lang), size);
       if (wrptr(&bufp, &size, bytes) != 0)
         WARN_STATIC_BUFFER();
       if (text)
@@ -142,20 +210,33 @@ char *getcommand(const order * ord)
   return _strdup(get_command(ord, sbuffer, sizeof(sbuffer)));
 }
 
+/* like items, orders are allocated in blocks and reused when freed */
+static block_allocator ocache = BLOCK_ALLOCATOR(order, 1024);
+
+static order *alloc_order(void)
+{
+  return (order *)ba_alloc(&ocache);
+}
+
+void free_orderblocks(void)
+{
+  ba_release(&ocache);
+}
+
 void free_order(order * ord)
 {
   if (ord != NULL) {
     assert(ord->next == 0);
 
     release_data(ord->data);
-    free(ord);
+    ba_free(&ocache, ord);
   }
 }
 
 order *copy_order(const order * src)
 {
   if (src != NULL) {
-    order *ord = (order *) malloc(sizeof(order));
+    order *ord = alloc_order();
     ord->next = NULL;
     ord->_persistent = src->_persistent;
     ord->data = src->data;
@@ -188,13 +269,27 @@ static order_data *create_data(keyword_t kwd, const char *sptr, int lindex)
   const char *s = sptr;
   order_data *data;
   const struct locale *lang = locale_array[lindex]->lang;
+  param_t param = NOPARAM;
+  skill_t sk = NOSKILL;
+  unsigned int hash;
 
-  if (kwd != NOKEYWORD)
+  if (kwd != NOKEYWORD) {
     s = (*sptr) ? sptr : NULL;
+    if (s) {
+      /* das erste Argument nur einmal parsen, siehe get_order_param */
+      char token[64];
+      parse_token_r(&sptr, token, sizeof(token));
+      if (token[0] > '@') {
+        param = findparam(token, lang);
+      }
+      if (kwd == K_STUDY) {
+        sk = findskill(token, lang);
+      }
+    }
+  }
 
   /* learning, only one order_data per skill required */
   if (kwd == K_STUDY) {
-    skill_t sk = findskill(parse_token(&sptr), lang);
     switch (sk) {
     case NOSKILL:              /* fehler */
       break;
@@ -205,10 +300,12 @@ static order_data *create_data(keyword_t kwd, const char *sptr, int lindex)
       data = locale_array[lindex]->study_orders[sk];
       if (data == NULL) {
         const char *skname = skillname(sk, lang);
-        data = (order_data *) malloc(sizeof(order_data));
+        data = (order_data *) calloc(1, sizeof(order_data));
         locale_array[lindex]->study_orders[sk] = data;
         data->_keyword = kwd;
         data->_lindex = lindex;
+        data->_param = param;
+        data->_skill = sk;
         if (strchr(skname, ' ') != NULL) {
           size_t len = strlen(skname);
           data->_str = malloc(len + 3);
@@ -227,24 +324,47 @@ static order_data *create_data(keyword_t kwd, const char *sptr, int lindex)
   }
 
   /* orders with no parameter, only one order_data per order required */
-  else if (kwd != NOKEYWORD && *sptr == 0) {
+  if (kwd != NOKEYWORD && s == NULL) {
     data = locale_array[lindex]->short_orders[kwd];
     if (data == NULL) {
-      data = (order_data *) malloc(sizeof(order_data));
+      data = (order_data *) calloc(1, sizeof(order_data));
       locale_array[lindex]->short_orders[kwd] = data;
       data->_keyword = kwd;
       data->_lindex = lindex;
+      data->_param = NOPARAM;
+      data->_skill = NOSKILL;
       data->_str = NULL;
       data->_refcount = 1;
     }
     ++data->_refcount;
     return data;
   }
+
+  /* all other orders are shared by their text */
+  hash = hash_data(kwd, s, lindex);
+  if (odata_size) {
+    for (data = odata_hash[hash % odata_size]; data; data = data->_nexthash) {
+      if (data->_hash == hash && data->_keyword == kwd
+        && data->_lindex == lindex && strcmp(data->_str, s) == 0) {
+        ++data->_refcount;
+        return data;
+      }
+    }
+  }
+  if (odata_count >= odata_size) {
+    rehash_data();
+  }
   data = (order_data *) malloc(sizeof(order_data));
   data->_keyword = kwd;
   data->_lindex = lindex;
-  data->_str = s ? _strdup(s) : NULL;
+  data->_param = param;
+  data->_skill = sk;
+  data->_str = _strdup(s);
   data->_refcount = 1;
+  data->_hash = hash;
+  data->_nexthash = odata_hash[hash % odata_size];
+  odata_hash[hash % odata_size] = data;
+  ++odata_count;
   return data;
 }
 
@@ -265,17 +385,27 @@ static order *create_order_i(keyword_t kwd, const char *sptr, int persistent,
     }
   }
 
-  for (lindex = 0; lindex != nlocales; ++lindex) {
-    if (locale_array[lindex]->lang == lang)
-      break;
-  }
-  if (lindex == nlocales) {
-    locale_array[nlocales] = (locale_data *) calloc(1, sizeof(locale_data));
-    locale_array[nlocales]->lang = lang;
-    ++nlocales;
+  lindex = (int)locale_index(lang);
+  if (locale_array[lindex] == NULL) {
+    locale_array[lindex] = (locale_data *) calloc(1, sizeof(locale_data));
+    locale_array[lindex]->lang = lang;
+  } else if (locale_array[lindex]->lang != lang) {
+    /* the locales were freed and made again: the new one takes over the
+     * index, but not the skill names cached for the old one */
+    locale_data *ld = locale_array[lindex];
+    int i;
+    for (i = 0; i != MAXKEYWORDS; ++i) {
+      release_data(ld->short_orders[i]);
+      ld->short_orders[i] = NULL;
+    }
+    for (i = 0; i != MAXSKILLS; ++i) {
+      release_data(ld->study_orders[i]);
+      ld->study_orders[i] = NULL;
+    }
+    ld->lang = lang;
   }
 
-  ord = (order *) malloc(sizeof(order));
+  ord = alloc_order();
   ord->_persistent = persistent;
   ord->next = NULL;
 
@@ -344,13 +474,14 @@ order *parse_order(const char *s, const struct locale * lang)
     keyword_t kwd;
     const char *sptr;
     int persistent = 0;
+    char token[64];
 
     while (*s == '@') {
       persistent = 1;
       ++s;
     }
     sptr = s;
-    kwd = findkeyword(parse_token(&sptr), lang);
+    kwd = findkeyword(parse_token_r(&sptr, token, sizeof(token)), lang);
     if (kwd != NOKEYWORD) {
       while (isxspace(*(unsigned char *)sptr))
         ++sptr;
@@ -372,8 +503,6 @@ order *parse_order(const char *s, const struct locale * lang)
 bool is_repeated(const order * ord)
 {
   keyword_t kwd = ORD_KEYWORD(ord);
-  const struct locale *lang = ORD_LOCALE(ord);
-  const char * s;
   int result = 0;
 
   switch (kwd) {
@@ -400,12 +529,7 @@ bool is_repeated(const order * ord)
 
   case K_FOLLOW:
     /* FOLLOW is only a long order if we are following a ship. */
-    parser_pushstate();
-    init_tokens(ord);
-    skip_token();
-    s = getstrtoken();
-    result = isparam(s, lang, P_SHIP);
-    parser_popstate();
+    result = ORD_PARAM(ord) == P_SHIP;
     break;
 
   case K_MAKE:
@@ -414,12 +538,7 @@ bool is_repeated(const order * ord)
      * behandelt wie die anderen (deswegen kein break nach case
      * K_MAKE) - und in thisorder (der aktuelle 30-Tage Befehl)
      * abgespeichert). */
-    parser_pushstate();
-    init_tokens(ord);           /* initialize token-parser */
-    skip_token();
-    s = getstrtoken();
-    result = !isparam(s, lang, P_TEMP);
-    parser_popstate();
+    result = ORD_PARAM(ord) != P_TEMP;
     break;
   default:
     result = 0;
@@ -438,7 +557,6 @@ bool is_repeated(const order * ord)
 bool is_exclusive(const order * ord)
 {
   keyword_t kwd = ORD_KEYWORD(ord);
-  const struct locale *lang = ORD_LOCALE(ord);
   int result = 0;
 
   switch (kwd) {
@@ -463,11 +581,7 @@ bool is_exclusive(const order * ord)
 
   case K_FOLLOW:
     /* FOLLOW is only a long order if we are following a ship. */
-    parser_pushstate();
-    init_tokens(ord);
-    skip_token();
-    result = isparam(getstrtoken(), lang, P_SHIP);
-    parser_popstate();
+    result = ORD_PARAM(ord) == P_SHIP;
     break;
 
   case K_MAKE:
@@ -476,11 +590,7 @@ bool is_exclusive(const order * ord)
      * behandelt wie die anderen (deswegen kein break nach case
      * K_MAKE) - und in thisorder (der aktuelle 30-Tage Befehl)
      * abgespeichert). */
-    parser_pushstate();
-    init_tokens(ord);           /* initialize token-parser */
-    skip_token();
-    result = !isparam(getstrtoken(), lang, P_TEMP);
-    parser_popstate();
+    result = ORD_PARAM(ord) != P_TEMP;
     break;
   default:
     result = 0;
@@ -499,7 +609,6 @@ bool is_exclusive(const order * ord)
 bool is_long(const order * ord)
 {
   keyword_t kwd = ORD_KEYWORD(ord);
-  const struct locale *lang = ORD_LOCALE(ord);
   bool result = false;
 
   switch (kwd) {
@@ -526,11 +635,7 @@ bool is_long(const order * ord)
 
   case K_FOLLOW:
     /* FOLLOW is only a long order if we are following a ship. */
-    parser_pushstate();
-    init_tokens(ord);
-    skip_token();
-    result = isparam(getstrtoken(), lang, P_SHIP);
-    parser_popstate();
+    result = ORD_PARAM(ord) == P_SHIP;
     break;
 
   case K_MAKE:
@@ -539,11 +644,7 @@ bool is_long(const order * ord)
      * behandelt wie die anderen (deswegen kein break nach case
      * K_MAKE) - und in thisorder (der aktuelle 30-Tage Befehl)
      * abgespeichert). */
-    parser_pushstate();
-    init_tokens(ord);           /* initialize token-parser */
-    skip_token();
-    result = !isparam(getstrtoken(), lang, P_TEMP);
-    parser_popstate();
+    result = ORD_PARAM(ord) != P_TEMP;
     break;
   default:
     result = false;
@@ -604,6 +705,7 @@ void push_order(order ** ordp, order * ord)
 
 void init_tokens(const struct order *ord)
 {
-  char *cmd = getcommand(ord);
-  init_tokens_str(cmd, cmd);
+  size_t size;
+  char *cmd = parser_buffer(&size);
+  init_tokens_str(get_command(ord, cmd, size), NULL);
 }
@@ -21,8 +21,8 @@ extern "C" {
  * This structure contains one order given by a unit. These used to be
  * stored in string lists, but by storing them in order-structures,
  * it is possible to use reference-counting on them, reduce string copies,
- * and reduce overall memory usage by sharing strings between orders (not
- * implemented yet) saving approx. 50% of all string-related memory.
+ * and reduce overall memory usage by sharing strings between orders,
+ * saving approx. 50% of all string-related memory.
  */
 
   struct order_data;
@@ -44,11 +44,14 @@ extern "C" {
   extern order *copy_order(const order * ord);
   extern void free_order(order * ord);
   extern void free_orders(order ** olist);
+  extern void free_orderblocks(void);
 
   extern void push_order(struct order **olist, struct order *ord);
 
 /* access functions for orders */
   extern keyword_t get_keyword(const order * ord);
+  extern param_t get_order_param(const order * ord);
+  extern skill_t get_order_skill(const order * ord);
   extern void set_order(order ** destp, order * src);
   extern char *getcommand(const order * ord);
   extern bool is_persistent(const order * ord);
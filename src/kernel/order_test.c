@@ -0,0 +1,128 @@
+#include <platform.h>
+
+#include <kernel/types.h>
+#include <kernel/config.h>
+#include <kernel/order.h>
+#include <kernel/skill.h>
+
+#include <CuTest.h>
+#include <tests.h>
+
+static void test_order_param(CuTest * tc)
+{
+  struct locale *lang;
+  order *ord;
+  bool enabled = skill_enabled[SK_CROSSBOW];
+
+  skill_enabled[SK_CROSSBOW] = true;
+  test_cleanup();
+  lang = test_create_locale();
+
+  ord = parse_order("FOLGE SCHIFF 1", lang);
+  CuAssertIntEquals(tc, K_FOLLOW, get_keyword(ord));
+  CuAssertIntEquals(tc, P_SHIP, get_order_param(ord));
+  CuAssertTrue(tc, is_long(ord));
+  free_order(ord);
+
+  ord = parse_order("FOLGE EINHEIT 1", lang);
+  CuAssertIntEquals(tc, P_UNIT, get_order_param(ord));
+  CuAssertTrue(tc, !is_long(ord));
+  free_order(ord);
+
+  ord = parse_order("MACHE TEMP 1", lang);
+  CuAssertIntEquals(tc, P_TEMP, get_order_param(ord));
+  CuAssertTrue(tc, !is_long(ord));
+  CuAssertTrue(tc, !is_repeated(ord));
+  free_order(ord);
+
+  ord = parse_order("MACHE 1", lang);
+  CuAssertIntEquals(tc, NOPARAM, get_order_param(ord));
+  CuAssertTrue(tc, is_long(ord));
+  free_order(ord);
+
+  ord = parse_order("MACHE", lang);
+  CuAssertIntEquals(tc, NOPARAM, get_order_param(ord));
+  free_order(ord);
+
+  ord = parse_order("LERNEN crossbow", lang);
+  CuAssertIntEquals(tc, K_STUDY, get_keyword(ord));
+  CuAssertIntEquals(tc, SK_CROSSBOW, get_order_skill(ord));
+  free_order(ord);
+
+  CuAssertIntEquals(tc, NOPARAM, get_order_param(NULL));
+  CuAssertIntEquals(tc, NOSKILL, get_order_skill(NULL));
+  skill_enabled[SK_CROSSBOW] = enabled;
+}
+
+static void test_order_shared(CuTest * tc)
+{
+  struct locale *lang;
+  order *ord1, *ord2;
+  char cmd[64];
+
+  test_cleanup();
+  lang = test_create_locale();
+
+  ord1 = parse_order("NACH O W", lang);
+  ord2 = parse_order("NACH  O W", lang);
+  CuAssertPtrEquals(tc, ord1->data, ord2->data);
+  free_order(ord2);
+
+  ord2 = parse_order("NACH O", lang);
+  CuAssertTrue(tc, ord1->data != ord2->data);
+  CuAssertStrEquals(tc, "NACH O", write_order(ord2, cmd, sizeof(cmd)));
+  free_order(ord2);
+
+  ord2 = parse_order("@NACH O W", lang);
+  CuAssertPtrEquals(tc, ord1->data, ord2->data);
+  CuAssertStrEquals(tc, "@NACH O W", write_order(ord2, cmd, sizeof(cmd)));
+  free_order(ord2);
+  free_order(ord1);
+
+  /* the last reference removes the text from the table */
+  ord1 = parse_order("NACH O W", lang);
+  CuAssertStrEquals(tc, "NACH O W", write_order(ord1, cmd, sizeof(cmd)));
+  free_order(ord1);
+}
+
+/* orders with one argument must not end up in short_orders */
+static void test_order_one_argument(CuTest * tc)
+{
+  struct locale *lang;
+  order *ord1, *ord2;
+  char cmd[64];
+  bool enabled = skill_enabled[SK_CROSSBOW];
+
+  skill_enabled[SK_CROSSBOW] = true;
+  test_cleanup();
+  lang = test_create_locale();
+
+  ord1 = parse_order("KAEMPFEN", lang);
+  ord2 = parse_order("KAEMPFEN HINTEN", lang);
+  CuAssertTrue(tc, ord1->data != ord2->data);
+  CuAssertStrEquals(tc, "KAEMPFEN", write_order(ord1, cmd, sizeof(cmd)));
+  CuAssertStrEquals(tc, "KAEMPFEN HINTEN", write_order(ord2, cmd, sizeof(cmd)));
+  free_order(ord1);
+  free_order(ord2);
+
+  ord1 = parse_order("NACH O", lang);
+  CuAssertStrEquals(tc, "NACH O", write_order(ord1, cmd, sizeof(cmd)));
+  free_order(ord1);
+
+  ord1 = parse_order("LERNEN crossbow", lang);
+  CuAssertStrEquals(tc, "LERNEN crossbow", write_order(ord1, cmd, sizeof(cmd)));
+  ord2 = parse_order(cmd, lang);
+  CuAssertIntEquals(tc, SK_CROSSBOW, get_order_skill(ord2));
+  free_order(ord1);
+  free_order(ord2);
+  skill_enabled[SK_CROSSBOW] = enabled;
+}
+
+CuSuite *get_order_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_order_param);
+  SUITE_ADD_TEST(suite, test_order_shared);
+  SUITE_ADD_TEST(suite, test_order_one_argument);
+  return suite;
+}
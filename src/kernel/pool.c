@@ -60,10 +60,7 @@ int get_resource(const unit * u, const resource_type * rtype)
     } else if (itype == olditemtype[R_IRON] && (u_race(u)->flags & RCF_IRONGOLEM)) {
       return u->number * GOLEM_IRON;
     } else {
-      const item *i = *i_findc(&u->items, itype);
-      if (i)
-        return i->number;
-      return 0;
+      return i_get(u->items, itype);
     }
   }
   if (rtype == oldresourcetype[R_AURA])
@@ -156,6 +153,46 @@ int set_resvalue(unit * u, const resource_type * rtype, int value)
   return res->value;
 }
 
+/* what u has of its own, reserved or not, depending on mode */
+static int own_share(const unit * u, const resource_type * rtype,
+  unsigned int mode, int have)
+{
+  if ((mode & GET_SLACK) && (mode & GET_RESERVE))
+    return have;
+  else {
+    int reserve = get_reservation(u, rtype);
+    int slack = MAX(0, have - reserve);
+    if (mode & GET_RESERVE)
+      return have - slack;
+    else if (mode & GET_SLACK)
+      return slack;
+  }
+  return 0;
+}
+
+/* which part of the pool unit v opens to faction f: GET_SLACK and/or
+ * GET_RESERVE, or 0. *lastf remembers the last faction that was asked
+ * about, units of one faction are usually next to each other. */
+static unsigned int pool_mask(const unit * v, const faction * f,
+  unsigned int mode, const faction ** lastf, int *allied)
+{
+  if (v->faction == f) {
+    return (mode >> 3) & (GET_SLACK | GET_RESERVE);
+  }
+  if (fval(v, UFL_GROUP)) {
+    /* groups have their own allies */
+    *lastf = NULL;
+    *allied = alliedunit(v, f, HELP_MONEY);
+  } else if (v->faction != *lastf) {
+    *lastf = v->faction;
+    *allied = alliedunit(v, f, HELP_MONEY);
+  }
+  if (*allied) {
+    return (mode >> 6) & (GET_SLACK | GET_RESERVE);
+  }
+  return 0;
+}
+
 int
 get_pooled(const unit * u, const resource_type * rtype, unsigned int mode,
   int count)
@@ -170,33 +207,28 @@ get_pooled(const unit * u, const resource_type * rtype, unsigned int mode,
     mode &= (GET_SLACK | GET_RESERVE);
   }
 
-  if ((mode & GET_SLACK) && (mode & GET_RESERVE))
-    use = have;
-  else {
-    int reserve = get_reservation(u, rtype);
-    int slack = MAX(0, have - reserve);
-    if (mode & GET_RESERVE)
-      use = have - slack;
-    else if (mode & GET_SLACK)
-      use = slack;
-  }
+  use = own_share(u, rtype, mode, have);
   if (rtype->flags & RTF_POOLED && mode & ~(GET_SLACK | GET_RESERVE)) {
+    const faction *lastf = NULL;
+    int allied = 0;
+
     for (v = r->units; v && use < count; v = v->next)
       if (u != v) {
-        int mask;
+        unsigned int mask;
 
         if (v->items == NULL && rtype->uget == NULL)
           continue;
         if ((urace(v)->ec_flags & GIVEITEM) == 0)
           continue;
 
-        if (v->faction == f) {
-          mask = (mode >> 3) & (GET_SLACK | GET_RESERVE);
-        } else if (alliedunit(v, f, HELP_MONEY))
-          mask = (mode >> 6) & (GET_SLACK | GET_RESERVE);
-        else
+        /* units that have nothing need not be asked about alliances */
+        have = get_resource(v, rtype);
+        if (have == 0)
           continue;
-        use += get_pooled(v, rtype, mask, count - use);
+        mask = pool_mask(v, f, mode, &lastf, &allied);
+        if (mask) {
+          use += own_share(v, rtype, mask, have);
+        }
       }
   }
   return use;
@@ -234,21 +266,23 @@ use_pooled(unit * u, const resource_type * rtype, unsigned int mode, int count)
   }
 
   if (rtype->flags & RTF_POOLED && mode & ~(GET_SLACK | GET_RESERVE)) {
+    const faction *lastf = NULL;
+    int allied = 0;
+
     for (v = r->units; use > 0 && v != NULL; v = v->next)
       if (u != v) {
-        int mask;
+        unsigned int mask;
         if ((urace(v)->ec_flags & GIVEITEM) == 0)
           continue;
         if (v->items == NULL && rtype->uget == NULL)
           continue;
-
-        if (v->faction == f) {
-          mask = (mode >> 3) & (GET_SLACK | GET_RESERVE);
-        } else if (alliedunit(v, f, HELP_MONEY))
-          mask = (mode >> 6) & (GET_SLACK | GET_RESERVE);
-        else
+        if (get_resource(v, rtype) == 0)
           continue;
-        use -= use_pooled(v, rtype, mask, use);
+
+        mask = pool_mask(v, f, mode, &lastf, &allied);
+        if (mask) {
+          use -= use_pooled(v, rtype, mask, use);
+        }
       }
   }
   return count - use;
@@ -2,15 +2,20 @@
 #include <kernel/types.h>
 
 #include "pool.h"
+#include "ally.h"
 #include "magic.h"
 #include "unit.h"
 #include "item.h"
+#include "faction.h"
+#include "race.h"
 #include "region.h"
 #include "skill.h"
 
 #include <CuTest.h>
 #include <tests.h>
 
+#include <limits.h>
+
 void test_change_resource(CuTest * tc)
 {
   struct unit * u;
@@ -38,10 +43,89 @@ void test_change_resource(CuTest * tc)
   }
 }
 
+static void test_get_pooled(CuTest * tc)
+{
+  const item_type *itype;
+  const resource_type *rtype;
+  struct unit *u = 0;
+  struct faction *f;
+  struct region *r;
+  struct race *rc;
+  int i;
+
+  test_cleanup();
+  test_create_world();
+  r = findregion(0, 0);
+  rc = test_create_race("dwarf");
+  rc->ec_flags |= GETITEM | GIVEITEM;
+  f = test_create_faction(rc);
+  itype = it_find("iron");
+  rtype = itype->rtype;
+  ((resource_type *)rtype)->flags |= RTF_POOLED;
+  for (i = 0; i != 500; ++i) {
+    u = test_create_unit(f, r);
+    if (i % 2 == 0) {
+      i_change(&u->items, itype, 2);
+    }
+  }
+  CuAssertIntEquals(tc, 0, get_resource(u, rtype));
+  CuAssertIntEquals(tc, 500, get_pooled(u, rtype, GET_DEFAULT, INT_MAX));
+  CuAssertIntEquals(tc, 0, get_pooled(u, rtype, GET_SLACK, INT_MAX));
+  CuAssertIntEquals(tc, 10, get_pooled(u, rtype, GET_DEFAULT, 10));
+}
+
+static void test_use_pooled_order(CuTest * tc)
+{
+  const item_type *itype;
+  const resource_type *rtype;
+  struct unit *u, *ua, *ub, *uc, *ud;
+  struct faction *f, *f2, *f3;
+  struct region *r;
+  struct race *rc;
+  ally *al;
+  unsigned int mode = GET_DEFAULT | GET_ALLIED_RESERVE;
+
+  test_cleanup();
+  test_create_world();
+  r = findregion(0, 0);
+  rc = test_create_race("dwarf");
+  rc->ec_flags |= GETITEM | GIVEITEM;
+  f = test_create_faction(rc);
+  f2 = test_create_faction(rc);
+  f3 = test_create_faction(rc);
+  al = ally_add(&f2->allies, f);
+  al->status = HELP_MONEY;
+  itype = it_find("iron");
+  rtype = itype->rtype;
+  ((resource_type *)rtype)->flags |= RTF_POOLED;
+
+  u = test_create_unit(f, r);
+  ua = test_create_unit(f3, r);
+  ub = test_create_unit(f2, r);
+  uc = test_create_unit(f, r);
+  ud = test_create_unit(f2, r);
+  i_change(&ua->items, itype, 10);
+  i_change(&ub->items, itype, 10);
+  i_change(&uc->items, itype, 10);
+  i_change(&ud->items, itype, 10);
+
+  /* allied units give their slack, strangers give nothing */
+  CuAssertIntEquals(tc, 30, get_pooled(u, rtype, mode, INT_MAX));
+  CuAssertIntEquals(tc, 10, get_pooled(u, rtype, GET_DEFAULT, INT_MAX));
+  /* units are drained in the order of the region */
+  CuAssertIntEquals(tc, 25, use_pooled(u, rtype, mode, 25));
+  CuAssertIntEquals(tc, 10, i_get(ua->items, itype));
+  CuAssertIntEquals(tc, 0, i_get(ub->items, itype));
+  CuAssertIntEquals(tc, 0, i_get(uc->items, itype));
+  CuAssertIntEquals(tc, 5, i_get(ud->items, itype));
+}
+
 CuSuite *get_pool_suite(void)
 {
   CuSuite *suite = CuSuiteNew();
 /*  SUITE_ADD_TEST(suite, test_pool); */
   SUITE_ADD_TEST(suite, test_change_resource);
+  SUITE_ADD_TEST(suite, test_get_pooled);
+  SUITE_ADD_TEST(suite, test_use_pooled_order);
   return suite;
 }
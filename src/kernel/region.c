@@ -496,7 +496,9 @@ void runhash(region * r)
       if (di >= MAXDIRECTIONS)
         di -= MAXDIRECTIONS;
       rc->connect[di] = NULL;
+      rc->borders[di] = NULL;
       r->connect[d] = NULL;
+      r->borders[d] = NULL;
     }
   }
 #endif
@@ -524,8 +526,12 @@ region *r_connect(const region * r, direction_t dir)
   result = rfindhash(x, y);
 #ifdef FAST_CONNECT
   if (result) {
+    /* not connected yet, so this is the one time it uses the hash */
+    connection *b = get_borders(r, result);
     rmodify->connect[dir] = result;
+    rmodify->borders[dir] = b;
     result->connect[back[dir]] = rmodify;
+    result->borders[back[dir]] = b;
   }
 #endif
   return result;
@@ -40,7 +40,7 @@ extern "C" {
 #define RF_BLOCK_WEST       (1<<8)
 
 #define RF_ENCOUNTER   (1<<9)
-#define RF_MIGRATION   (1<<10)
+#define RF_UNUSED_2    (1<<10)
 #define RF_UNUSED_1    (1<<11)
 #define RF_ORCIFIED    (1<<12)
 #define RF_CURSED      (1<<13)
@@ -139,6 +139,7 @@ extern "C" {
     struct rawmaterial *resources;
 #ifdef FAST_CONNECT
     struct region *connect[MAXDIRECTIONS];      /* use rconnect(r, dir) to access */
+    struct connection *borders[MAXDIRECTIONS];  /* use get_borders(r, rconnect(r, dir)) */
 #endif
   } region;
 
@@ -342,20 +342,13 @@ void
 report_building(const struct building *b, const char **name,
   const char **illusion)
 {
-  static int init;
-  static const struct building_type *bt_illusion;
-
   if (name) {
     *name = buildingtype(b->type, b, b->size);
   }
   if (illusion) {
     *illusion = NULL;
 
-    if (!init) {
-      bt_illusion = bt_find("illusioncastle");
-      init = 1;
-    }
-    if (bt_illusion && b->type == bt_illusion) {
+    if (b->type == bt_get(BT_ILLUSIONCASTLE)) {
       const attrib *a = a_findc(b->attribs, &at_icastle);
       if (a != NULL) {
         icastle_data *icastle = (icastle_data *) a->data.v;
@@ -1032,7 +1025,7 @@ void transfer_seen(quicklist ** dst, quicklist ** src)
 static void get_addresses(report_context * ctx)
 {
 /* "TODO: travelthru" */
-  seen_region *sr = NULL;
+  seen_region *sr, *send = ctx->seen->regions + ctx->seen->size;
   region *r;
   const faction *lastf = NULL;
   quicklist *flist = 0;
@@ -1050,12 +1043,7 @@ static void get_addresses(report_context * ctx)
     }
   }
 
-  /* find the first region that this faction can see */
-  for (r = ctx->first; sr == NULL && r != ctx->last; r = r->next) {
-    sr = find_seen(ctx->seen, r);
-  }
-
-  for (; sr != NULL; sr = sr->next) {
+  for (sr = ctx->seen->regions; sr != send; ++sr) {
     int stealthmod = stealth_modifier(sr->mode);
     r = sr->r;
     if (sr->mode == see_lighthouse) {
@@ -1119,72 +1107,79 @@ static void get_addresses(report_context * ctx)
   ctx->addresses = flist;
 }
 
-#define MAXSEEHASH 0x1000
-seen_region *reuse;
-
-seen_region **seen_init(void)
+seen_map *seen_init(void)
 {
-  return (seen_region **) calloc(MAXSEEHASH, sizeof(seen_region *));
+  return (seen_map *)calloc(1, sizeof(seen_map));
 }
 
-void seen_done(seen_region * seehash[])
+void seen_done(seen_map * seen)
 {
-  int i;
-  for (i = 0; i != MAXSEEHASH; ++i) {
-    seen_region *sd = seehash[i];
-    if (sd == NULL)
-      continue;
-    while (sd->nextHash != NULL)
-      sd = sd->nextHash;
-    sd->nextHash = reuse;
-    reuse = seehash[i];
-    seehash[i] = NULL;
+  if (seen) {
+    free(seen->regions);
+    free(seen->hash);
+    free(seen);
   }
-  /*  free(seehash); */
 }
 
-void free_seen(void)
+static int cmp_seen(const void *a, const void *b)
 {
-  while (reuse) {
-    seen_region *r = reuse;
-    reuse = reuse->nextHash;
-    free(r);
-  }
+  const seen_region *sa = (const seen_region *)a;
+  const seen_region *sb = (const seen_region *)b;
+  if (sa->r->index < sb->r->index)
+    return -1;
+  return (sa->r->index > sb->r->index) ? 1 : 0;
 }
 
-void
-link_seen(seen_region * seehash[], const region * first, const region * last)
+void sort_seen(seen_map * seen)
 {
-  const region *r = first;
-  seen_region *sr = NULL;
-
-  if (first == last)
-    return;
+  /* every region is in the vector only once, so this sort is stable.
+   * positions change, so the hash is rebuilt when it is next needed. */
+  qsort(seen->regions, seen->size, sizeof(seen_region), cmp_seen);
+  free(seen->hash);
+  seen->hash = NULL;
+  seen->hashsize = 0;
+}
 
-  do {
-    sr = find_seen(seehash, r);
-    r = r->next;
-  } while (sr == NULL && r != last);
+static void hash_seen(seen_map * seen, unsigned int hashsize)
+{
+  unsigned int i;
 
-  while (r != last) {
-    seen_region *sn = find_seen(seehash, r);
-    if (sn != NULL) {
-      sr->next = sn;
-      sr = sn;
+  free(seen->hash);
+  seen->hash = (unsigned int *)calloc(hashsize, sizeof(unsigned int));
+  seen->hashsize = hashsize;
+  for (i = 0; i != seen->size; ++i) {
+    unsigned int key = reg_hashkey(seen->regions[i].r) & (hashsize - 1);
+    while (seen->hash[key]) {
+      key = (key + 1) & (hashsize - 1);
     }
-    r = r->next;
+    seen->hash[key] = i + 1;
   }
-  sr->next = 0;
 }
 
-seen_region *find_seen(struct seen_region *seehash[], const region * r)
+seen_region *find_seen(seen_map * seen, const region * r)
 {
-  unsigned int index = reg_hashkey(r) & (MAXSEEHASH - 1);
-  seen_region *find = seehash[index];
-  while (find) {
-    if (find->r == r)
-      return find;
-    find = find->nextHash;
+  if (seen->hash) {
+    unsigned int key = reg_hashkey(r) & (seen->hashsize - 1);
+    while (seen->hash[key]) {
+      seen_region *sr = seen->regions + seen->hash[key] - 1;
+      if (sr->r == r)
+        return sr;
+      key = (key + 1) & (seen->hashsize - 1);
+    }
+  } else {
+    /* sorted by region index, use binary search */
+    unsigned int lo = 0, hi = seen->size;
+    while (lo < hi) {
+      unsigned int mid = (lo + hi) / 2;
+      seen_region *sr = seen->regions + mid;
+      if (sr->r->index < r->index) {
+        lo = mid + 1;
+      } else if (sr->r->index > r->index) {
+        hi = mid;
+      } else {
+        return sr;
+      }
+    }
   }
   return NULL;
 }
@@ -1193,36 +1188,61 @@ static void get_seen_interval(report_context * ctx)
 {
   /* this is required to find the neighbour regions of the ones we are in,
    * which may well be outside of [firstregion, lastregion) */
-  int i;
-  for (i = 0; i != MAXSEEHASH; ++i) {
-    seen_region *sr = ctx->seen[i];
-    while (sr != NULL) {
-      if (ctx->first == NULL || sr->r->index < ctx->first->index) {
-        ctx->first = sr->r;
-      }
-      if (ctx->last != NULL && sr->r->index >= ctx->last->index) {
-        ctx->last = sr->r->next;
-      }
-      sr = sr->nextHash;
+  seen_map *seen = ctx->seen;
+
+  sort_seen(seen);
+  if (seen->size > 0) {
+    region *r = seen->regions[0].r;
+    if (ctx->first == NULL || r->index < ctx->first->index) {
+      ctx->first = r;
+    }
+    r = seen->regions[seen->size - 1].r;
+    if (ctx->last != NULL && r->index >= ctx->last->index) {
+      ctx->last = r->next;
     }
   }
-  link_seen(ctx->seen, ctx->first, ctx->last);
 }
 
 bool
-add_seen(struct seen_region *seehash[], struct region *r, unsigned char mode,
+add_seen(struct seen_map *seen, struct region *r, unsigned char mode,
   bool dis)
 {
-  seen_region *find = find_seen(seehash, r);
+  seen_region *find = NULL;
+
+  /* prepare_reports adds regions in order, so most of the time this
+   * region is the one we added last */
+  if (seen->size > 0 && seen->regions[seen->size - 1].r == r) {
+    find = seen->regions + seen->size - 1;
+  } else {
+    if (!seen->hash) {
+      unsigned int hashsize = 32;
+      while (hashsize < seen->size * 2) {
+        hashsize *= 2;
+      }
+      hash_seen(seen, hashsize);
+    }
+    find = find_seen(seen, r);
+  }
   if (find == NULL) {
-    unsigned int index = reg_hashkey(r) & (MAXSEEHASH - 1);
-    if (!reuse)
-      reuse = (seen_region *) calloc(1, sizeof(struct seen_region));
-    find = reuse;
-    reuse = reuse->nextHash;
-    find->nextHash = seehash[index];
-    seehash[index] = find;
+    unsigned int key;
+    if (seen->size == seen->maxsize) {
+      seen->maxsize = seen->maxsize ? seen->maxsize * 2 : 16;
+      seen->regions = (seen_region *)realloc(seen->regions,
+        seen->maxsize * sizeof(seen_region));
+    }
+    find = seen->regions + seen->size++;
     find->r = r;
+    find->mode = see_none;
+    find->disbelieves = false;
+    if (seen->size * 2 > seen->hashsize) {
+      hash_seen(seen, seen->hashsize * 2);
+    } else {
+      key = reg_hashkey(r) & (seen->hashsize - 1);
+      while (seen->hash[key]) {
+        key = (key + 1) & (seen->hashsize - 1);
+      }
+      seen->hash[key] = seen->size;
+    }
   } else if (find->mode >= mode) {
     return false;
   }
@@ -1250,37 +1270,7 @@ void register_reporttype(const char *extension, report_fun write, int flag)
   report_types = type;
 }
 
-static quicklist *get_regions_distance(region * root, int radius)
-{
-  quicklist *ql, *rlist = NULL;
-  int qi = 0;
-
-  ql_push(&rlist, root);
-  fset(root, RF_MARK);
-  ql = rlist;
-
-  while (ql) {
-    region *r = (region *)ql_get(ql, qi);
-    region * next[MAXDIRECTIONS];
-    int d;
-    get_neighbours(r, next);
-
-    for (d = 0; d != MAXDIRECTIONS; ++d) {
-      if (next[d] && !fval(next[d], RF_MARK) && distance(next[d], root) <= radius) {
-        ql_push(&rlist, next[d]);
-        fset(next[d], RF_MARK);
-      }
-    }
-    ql_advance(&ql, &qi, 1);
-  }
-  for (ql=rlist,qi=0;ql;ql_advance(&ql, &qi, 1)) {
-    region *r = (region *)ql_get(ql, qi);
-    freset(r, RF_MARK);
-  }
-  return rlist;
-}
-
-static void view_default(struct seen_region **seen, region * r, faction * f)
+static void view_default(struct seen_map *seen, region * r, faction * f)
 {
   int dir;
   for (dir = 0; dir != MAXDIRECTIONS; ++dir) {
@@ -1298,7 +1288,7 @@ static void view_default(struct seen_region **seen, region * r, faction * f)
   }
 }
 
-static void view_neighbours(struct seen_region **seen, region * r, faction * f)
+static void view_neighbours(struct seen_map *seen, region * r, faction * f)
 {
   int d;
   region * nb[MAXDIRECTIONS];
@@ -1338,7 +1328,7 @@ static void view_neighbours(struct seen_region **seen, region * r, faction * f)
 }
 
 static void
-recurse_regatta(struct seen_region **seen, region * center, region * r,
+recurse_regatta(struct seen_map *seen, region * center, region * r,
   faction * f, int maxdist)
 {
   int d;
@@ -1370,7 +1360,7 @@ recurse_regatta(struct seen_region **seen, region * center, region * r,
   }
 }
 
-static void view_regatta(struct seen_region **seen, region * r, faction * f)
+static void view_regatta(struct seen_map *seen, region * r, faction * f)
 {
   unit *u;
   int skill = 0;
@@ -1384,13 +1374,51 @@ static void view_regatta(struct seen_region **seen, region * r, faction * f)
   recurse_regatta(seen, r, r, f, skill / 2);
 }
 
-static void prepare_lighthouse(building * b, faction * f)
+#define LIGHTHOUSE_MAXRANGE 10 /* (int)log10(INT_MAX) + 1 */
+
+/* all regions up to radius around root, in one search. a region is
+ * reached for range k if a path of regions no further than k from the
+ * root leads to it, so a region behind a hole in the map may need a
+ * larger k than its distance. the list is ordered by that k, and
+ * reach[k] is the number of regions reached for range k. */
+static quicklist *get_regions_reach(region * root, int radius, int reach[])
+{
+  quicklist *ql, *rlist = NULL;
+  int qi, k;
+
+  ql_push(&rlist, root);
+  fset(root, RF_MARK);
+  for (k = 0; k <= radius; ++k) {
+    for (ql = rlist, qi = 0; ql; ql_advance(&ql, &qi, 1)) {
+      region *r = (region *)ql_get(ql, qi);
+      region * next[MAXDIRECTIONS];
+      int d;
+      get_neighbours(r, next);
+
+      for (d = 0; d != MAXDIRECTIONS; ++d) {
+        if (next[d] && !fval(next[d], RF_MARK) && distance(next[d], root) <= k) {
+          ql_push(&rlist, next[d]);
+          fset(next[d], RF_MARK);
+        }
+      }
+    }
+    reach[k] = ql_length(rlist);
+  }
+  for (ql = rlist, qi = 0; ql; ql_advance(&ql, &qi, 1)) {
+    region *r = (region *)ql_get(ql, qi);
+    freset(r, RF_MARK);
+  }
+  return rlist;
+}
+
+static void
+lighthouse_view(quicklist * rlist, int nregions, faction * f)
 {
-  int range = lighthouse_range(b, f);
-  quicklist *ql, *rlist = get_regions_distance(b->region, range);
+  quicklist *ql;
   int qi;
 
-  for (ql=rlist,qi=0;ql;ql_advance(&ql, &qi,1)) {
+  for (ql = rlist, qi = 0; ql && nregions > 0;
+    ql_advance(&ql, &qi, 1), --nregions) {
     region *rl = (region *)ql_get(ql, qi);
     if (!fval(rl->terrain, FORBIDDEN_REGION)) {
       region * next[MAXDIRECTIONS];
@@ -1405,6 +1433,32 @@ static void prepare_lighthouse(building * b, faction * f)
       }
     }
   }
+}
+
+static void prepare_lighthouse(building * b)
+{
+  /* the regions around the lighthouse are collected only once, for the
+   * best observer inside. each faction then sees the regions that its
+   * own range reaches, exactly as if it had searched for itself. */
+  region *r = b->region;
+  int reach[LIGHTHOUSE_MAXRANGE + 1];
+  int range = lighthouse_range(b, NULL);
+  quicklist *rlist;
+  unit *u;
+
+  assert(range <= LIGHTHOUSE_MAXRANGE);
+  rlist = get_regions_reach(r, range, reach);
+  for (u = r->units; u; u = u->next) {
+    if (u->building == b && !fval(u->faction, FFL_MARK)) {
+      fset(u->faction, FFL_MARK);
+      lighthouse_view(rlist, reach[lighthouse_range(b, u->faction)], u->faction);
+    }
+  }
+  for (u = r->units; u; u = u->next) {
+    if (u->building == b) {
+      freset(u->faction, FFL_MARK);
+    }
+  }
   ql_free(rlist);
 }
 
@@ -1500,14 +1554,11 @@ void reorder_units(region * r)
   }
 }
 
-static void prepare_reports(void)
+void prepare_reports(void)
 {
   region *r;
   faction *f;
-  static const struct building_type *bt_lighthouse = NULL;
-  if (bt_lighthouse == NULL) {
-    bt_lighthouse = bt_find("lighthouse");
-  }
+  const struct building_type *bt_lighthouse = bt_get(BT_LIGHTHOUSE);
   for (f = factions; f; f = f->next) {
     if (f->seen)
       seen_done(f->seen);
@@ -1517,10 +1568,18 @@ static void prepare_reports(void)
   for (r = regions; r; r = r->next) {
     attrib *ru;
     unit *u;
+    building *b;
     plane *p = rplane(r);
 
     reorder_units(r);
 
+    for (b = r->buildings; b; b = b->next) {
+      if (b->type == bt_lighthouse) {
+        /* units in a lighthouse see the regions around it */
+        prepare_lighthouse(b);
+      }
+    }
+
     if (p) {
       watcher *w = p->watchers;
       for (; w; w = w->next) {
@@ -1532,11 +1591,6 @@ static void prepare_reports(void)
     }
 
     for (u = r->units; u; u = u->next) {
-      if (u->building && u->building->type == bt_lighthouse) {
-        /* we are in a lighthouse. add the regions we can see from here! */
-        prepare_lighthouse(u->building, u->faction);
-      }
-
       if (u_race(u) != new_race[RC_SPELL] || u->number == RS_FARVISION) {
         if (fval(u, UFL_DISBELIEVES)) {
           add_seen(u->faction->seen, r, see_unit, true);
@@ -1560,32 +1614,38 @@ static void prepare_reports(void)
   }
 }
 
-static seen_region **prepare_report(faction * f)
+static seen_map *prepare_report(faction * f)
 {
-  struct seen_region *sr;
-  region *r = firstregion(f);
+  seen_map *seen = f->seen;
+  region *first = firstregion(f);
   region *last = lastregion(f);
-
-  link_seen(f->seen, r, last);
-
-  for (sr = NULL; sr == NULL && r != last; r = r->next) {
-    sr = find_seen(f->seen, r);
-  }
-
-  for (; sr != NULL; sr = sr->next) {
+  unsigned int i, size;
+
+  /* visit the regions in order. regions that are added while we look
+   * around are appended to the vector and not visited. */
+  sort_seen(seen);
+  size = seen->size;
+  for (i = 0; i != size; ++i) {
+    seen_region *sr = seen->regions + i;
+    region *r = sr->r;
+    if (first && r->index < first->index) {
+      continue;
+    }
+    if (!first || (last && r->index >= last->index)) {
+      break;
+    }
     if (sr->mode > see_neighbour) {
-      region *r = sr->r;
       plane *p = rplane(r);
-      void (*view) (struct seen_region **, region *, faction *) = view_default;
+      void (*view) (struct seen_map *, region *, faction *) = view_default;
 
       if (p && fval(p, PFL_SEESPECIAL)) {
         /* TODO: this is not very customizable */
         view = (strcmp(p->name, "Regatta")==0) ? view_regatta : view_neighbours;
       }
-      view(f->seen, r, f);
+      view(seen, r, f);
     }
   }
-  return f->seen;
+  return seen;
 }
 
 int write_reports(faction * f, time_t ltime)
@@ -1644,6 +1704,7 @@ int write_reports(faction * f, time_t ltime)
   }
   ql_free(ctx.addresses);
   seen_done(ctx.seen);
+  f->seen = NULL;
   return 0;
 }
 
@@ -1772,7 +1833,6 @@ int reports(void)
   }
   if (mailit)
     fclose(mailit);
-  free_seen();
 #ifdef GLOBAL_REPORT
   {
     const char *str = get_param(global.parameters, "globalreport");
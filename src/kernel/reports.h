@@ -52,6 +52,7 @@ extern "C" {
   extern int reports(void);
   extern int write_reports(struct faction *f, time_t ltime);
   extern int init_reports(void);
+  extern void prepare_reports(void);
   extern void reorder_units(struct region * r);
 
   extern const struct unit *ucansee(const struct faction *f,
@@ -73,28 +74,34 @@ extern "C" {
   extern int stealth_modifier(int seen_mode);
 
   typedef struct seen_region {
-    struct seen_region *nextHash;
-    struct seen_region *next;
     struct region *r;
     unsigned char mode;
     bool disbelieves;
   } seen_region;
 
-  extern struct seen_region *find_seen(struct seen_region *seehash[],
+/* the regions a faction can see, as a vector of seen_region.
+ * the vector is sorted by region index after sort_seen(), and the hash
+ * is only kept while regions are being added. */
+  typedef struct seen_map {
+    struct seen_region *regions;
+    unsigned int size, maxsize;
+    unsigned int *hash;
+    unsigned int hashsize;
+  } seen_map;
+
+  extern struct seen_region *find_seen(struct seen_map *seen,
     const struct region *r);
-  extern bool add_seen(struct seen_region *seehash[], struct region *r,
+  extern bool add_seen(struct seen_map *seen, struct region *r,
     unsigned char mode, bool dis);
-  extern struct seen_region **seen_init(void);
-  extern void seen_done(struct seen_region *seehash[]);
-  extern void free_seen(void);
-  extern void link_seen(seen_region * seehash[], const struct region *first,
-    const struct region *last);
+  extern struct seen_map *seen_init(void);
+  extern void seen_done(struct seen_map *seen);
+  extern void sort_seen(struct seen_map *seen);
   extern const char *visibility[];
 
   typedef struct report_context {
     struct faction *f;
     struct quicklist *addresses;
-    struct seen_region **seen;
+    struct seen_map *seen;
     struct region *first, *last;
     void *userdata;
     time_t report_time;
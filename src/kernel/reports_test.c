@@ -1,9 +1,13 @@
 #include <platform.h>
 
+#include <kernel/config.h>
 #include <kernel/building.h>
+#include <kernel/faction.h>
 #include <kernel/reports.h>
 #include <kernel/region.h>
 #include <kernel/ship.h>
+#include <kernel/skill.h>
+#include <kernel/terrain.h>
 #include <kernel/unit.h>
 
 #include <CuTest.h>
@@ -74,10 +78,136 @@ static void test_regionid(CuTest * tc) {
   CuAssertIntEquals(tc, (char)-2, buffer[11]);
 }
 
+static void test_seen_map(CuTest * tc)
+{
+  const struct terrain_type * plain;
+  struct region *r1, *r2, *r3;
+  seen_map *seen;
+
+  test_cleanup();
+  plain = test_create_terrain("plain", 0);
+  r1 = test_create_region(0, 0, plain);
+  r2 = test_create_region(1, 0, plain);
+  r3 = test_create_region(2, 0, plain);
+
+  seen = seen_init();
+  CuAssertPtrEquals(tc, 0, find_seen(seen, r1));
+  CuAssertTrue(tc, add_seen(seen, r3, see_neighbour, false));
+  CuAssertTrue(tc, add_seen(seen, r1, see_unit, true));
+  CuAssertTrue(tc, add_seen(seen, r3, see_far, false));
+  CuAssertTrue(tc, !add_seen(seen, r3, see_neighbour, true));
+  CuAssertIntEquals(tc, 2, seen->size);
+  CuAssertIntEquals(tc, see_far, find_seen(seen, r3)->mode);
+  CuAssertTrue(tc, !find_seen(seen, r3)->disbelieves);
+  CuAssertTrue(tc, find_seen(seen, r1)->disbelieves);
+  CuAssertPtrEquals(tc, 0, find_seen(seen, r2));
+
+  sort_seen(seen);
+  CuAssertPtrEquals(tc, r1, seen->regions[0].r);
+  CuAssertPtrEquals(tc, r3, seen->regions[1].r);
+  CuAssertPtrEquals(tc, seen->regions + 1, find_seen(seen, r3));
+  CuAssertPtrEquals(tc, 0, find_seen(seen, r2));
+
+  CuAssertTrue(tc, add_seen(seen, r2, see_lighthouse, false));
+  CuAssertIntEquals(tc, see_lighthouse, find_seen(seen, r2)->mode);
+  CuAssertIntEquals(tc, see_unit, find_seen(seen, r1)->mode);
+  seen_done(seen);
+}
+
+static void test_lighthouse_view(CuTest * tc)
+{
+  region *r;
+  building *b;
+  unit *u;
+  struct faction *f1, *f2;
+  building_type *btype;
+  int perception = skill_enabled[SK_PERCEPTION];
+
+  test_cleanup();
+  test_create_world();
+  skill_enabled[SK_PERCEPTION] = 0;
+  btype = test_create_buildingtype("lighthouse");
+
+  r = findregion(0, 0);
+  b = test_create_building(r, btype);
+  b->size = 100;
+  f1 = test_create_faction(0);
+  f2 = test_create_faction(0);
+  u = test_create_unit(f1, r);
+  u_set_building(u, b);
+  u = test_create_unit(f1, r);
+  u_set_building(u, b);
+  test_create_unit(f2, findregion(1, 0));
+
+  prepare_reports();
+  CuAssertIntEquals(tc, see_unit, find_seen(f1->seen, r)->mode);
+  CuAssertIntEquals(tc, see_lighthouse, find_seen(f1->seen, findregion(2, 0))->mode);
+  CuAssertIntEquals(tc, see_unit, find_seen(f2->seen, findregion(1, 0))->mode);
+  CuAssertPtrEquals(tc, 0, find_seen(f2->seen, findregion(2, 0)));
+  skill_enabled[SK_PERCEPTION] = perception;
+}
+
+/* a faction with a shorter range does not see around holes in the map */
+static void test_lighthouse_range(CuTest * tc)
+{
+  region *r, *rx;
+  building *b;
+  unit *u;
+  struct faction *f1, *f2;
+  building_type *btype;
+  struct terrain_type *t_plain;
+  bool perception = skill_enabled[SK_PERCEPTION];
+
+  test_cleanup();
+  skill_enabled[SK_PERCEPTION] = true;
+  test_create_locale();
+  test_create_race("human");
+  t_plain = test_create_terrain("plain", LAND_REGION);
+  /* building types outlive test_cleanup, prepare_reports uses the first */
+  btype = (building_type *)bt_get(BT_LIGHTHOUSE);
+  if (!btype) {
+    btype = test_create_buildingtype("lighthouse");
+  }
+  btype->capacity = 1;
+  btype->maxcapacity = -1;
+
+  /* (2,-2) is two regions away, but the path to it leads through (3,-1)
+   * and (3,-2), which are three regions away */
+  r = test_create_region(0, 0, t_plain);
+  test_create_region(1, 0, t_plain);
+  test_create_region(2, 0, t_plain);
+  test_create_region(3, -1, t_plain);
+  test_create_region(3, -2, t_plain);
+  rx = test_create_region(2, -2, t_plain);
+
+  b = test_create_building(r, btype);
+  b->size = 100;
+  fset(b, BLD_WORKING);
+  f1 = test_create_faction(0);
+  f2 = test_create_faction(0);
+  u = test_create_unit(f1, r);
+  u_set_building(u, b);
+  set_level(u, SK_PERCEPTION, 9);
+  u = test_create_unit(f2, r);
+  u_set_building(u, b);
+  set_level(u, SK_PERCEPTION, 6);
+  CuAssertIntEquals(tc, 3, lighthouse_range(b, f1));
+  CuAssertIntEquals(tc, 2, lighthouse_range(b, f2));
+
+  prepare_reports();
+  CuAssertIntEquals(tc, see_lighthouse, find_seen(f1->seen, rx)->mode);
+  CuAssertIntEquals(tc, see_lighthouse, find_seen(f2->seen, findregion(2, 0))->mode);
+  CuAssertPtrEquals(tc, 0, find_seen(f2->seen, rx));
+  skill_enabled[SK_PERCEPTION] = perception;
+}
+
 CuSuite *get_reports_suite(void)
 {
   CuSuite *suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_reorder_units);
   SUITE_ADD_TEST(suite, test_regionid);
+  SUITE_ADD_TEST(suite, test_seen_map);
+  SUITE_ADD_TEST(suite, test_lighthouse_view);
+  SUITE_ADD_TEST(suite, test_lighthouse_range);
   return suite;
 }
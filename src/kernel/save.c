@@ -118,7 +118,23 @@ char *rns(FILE * f, char *c, size_t size)
 extern unsigned int __at_hashkey(const char *s);
 
 
-static unit *unitorders(FILE * F, int enc, struct faction *f)
+/* Die Befehlsdatei wird mit einem lokalen Cursor geparst, nicht mit dem
+ * globalen Parser-Zustand. */
+static int readid(const char **cursor)
+{
+  char token[64];
+  int i = atoi36(parse_token_r(cursor, token, sizeof(token)));
+  return (i < 0) ? -1 : i;
+}
+
+static param_t readparam(const char **cursor, const struct locale *lang)
+{
+  char token[64];
+  return findparam(parse_token_r(cursor, token, sizeof(token)), lang);
+}
+
+static unit *unitorders(filereader * fr, const char **linep,
+  struct faction *f, const char *cursor)
 {
   int i;
   unit *u;
@@ -126,7 +142,7 @@ static unit *unitorders(FILE * F, int enc, struct faction *f)
   if (!f)
     return NULL;
 
-  i = getid();
+  i = readid(&cursor);
   u = findunitg(i, NULL);
 
   if (u && u_race(u) == new_race[RC_SPELL])
@@ -162,14 +178,16 @@ static unit *unitorders(FILE * F, int enc, struct faction *f)
        * eingegeben wurde, checken wir, ob nun eine neue
        * Einheit oder ein neuer Spieler drankommt */
 
-      s = getbuf(F, enc);
+      s = filereader_getline(fr);
+      *linep = s;
       if (s == NULL)
         break;
 
       if (s[0]) {
         if (s[0]!='@') {
+          char token[64];
           const char *stok = s;
-          stok = parse_token(&stok);
+          stok = parse_token_r(&stok, token, sizeof(token));
 
           if (stok) {
             bool quit = false;
@@ -214,15 +232,16 @@ static unit *unitorders(FILE * F, int enc, struct faction *f)
   return u;
 }
 
-static faction *factionorders(void)
+static faction *factionorders(const char *cursor)
 {
   faction *f = NULL;
-  int fid = getid();
+  int fid = readid(&cursor);
 
   f = findfaction(fid);
 
   if (f != NULL && !is_monsters(f)) {
-    const char *pass = getstrtoken();
+    char token[256];
+    const char *pass = parse_token_r(&cursor, token, sizeof(token));
 
     if (!checkpasswd(f, (const char *)pass, true)) {
       log_warning("Invalid password for faction %s\n", itoa36(fid));
@@ -245,56 +264,52 @@ static faction *factionorders(void)
 
 /* ------------------------------------------------------------- */
 
-static param_t igetparam(const char *s, const struct locale *lang)
-{
-  return findparam(igetstrtoken(s), lang);
-}
-
 int readorders(const char *filename)
 {
-  FILE *F = NULL;
+  filereader *fr;
   const char *b;
   int nfactions = 0;
   struct faction *f = NULL;
 
-  F = fopen(filename, "rb");
-  if (!F) {
+  fr = filereader_open(filename, enc_gamedata);
+  if (!fr) {
     perror(filename);
     return -1;
   }
   if (verbosity >= 1)
     puts(" - lese Befehlsdatei...\n");
 
-  /* TODO: recognize UTF8 BOM */
-  b = getbuf(F, enc_gamedata);
+  b = filereader_getline(fr);
 
   /* Auffinden der ersten Partei, und danach abarbeiten bis zur letzten
    * Partei */
 
   while (b) {
     const struct locale *lang = f ? f->locale : default_locale;
+    const char *cursor = b;
     int p;
-    switch (igetparam(b, lang)) {
+    switch (readparam(&cursor, lang)) {
 #undef LOCALE_CHANGE
 #ifdef LOCALE_CHANGE
     case P_LOCALE:
       {
-        const char *s = getstrtoken();
+        char token[64];
+        const char *s = parse_token_r(&cursor, token, sizeof(token));
         if (f && find_locale(s)) {
           f->locale = find_locale(s);
         }
       }
-      b = getbuf(F, enc_gamedata);
+      b = filereader_getline(fr);
       break;
 #endif
     case P_GAMENAME:
     case P_FACTION:
-      f = factionorders();
+      f = factionorders(cursor);
       if (f) {
         ++nfactions;
       }
 
-      b = getbuf(F, enc_gamedata);
+      b = filereader_getline(fr);
       break;
 
       /* in factionorders wird nur eine zeile gelesen:
@@ -303,12 +318,13 @@ int readorders(const char *filename)
        * vermerkt. */
 
     case P_UNIT:
-      if (!f || !unitorders(F, enc_gamedata, f))
+      if (!f || !unitorders(fr, &b, f, cursor))
         do {
-          b = getbuf(F, enc_gamedata);
+          b = filereader_getline(fr);
           if (!b)
             break;
-          p = (b[0]=='@') ? NOPARAM : igetparam(b, lang);
+          cursor = b;
+          p = (b[0]=='@') ? NOPARAM : readparam(&cursor, lang);
         } while ((p != P_UNIT || !f) && p != P_FACTION && p != P_NEXT
           && p != P_GAMENAME);
       break;
@@ -322,16 +338,16 @@ int readorders(const char *filename)
 
     case P_NEXT:
       f = NULL;
-      b = getbuf(F, enc_gamedata);
+      b = filereader_getline(fr);
       break;
 
     default:
-      b = getbuf(F, enc_gamedata);
+      b = filereader_getline(fr);
       break;
     }
   }
 
-  fclose(F);
+  filereader_close(fr);
   if (verbosity >= 1)
     puts("\n");
   log_printf(stdout, "   %d Befehlsdateien gelesen\n", nfactions);
@@ -562,14 +578,234 @@ int current_turn(void)
   return cturn;
 }
 
+/* Die meisten Einheiten wiederholen jede Runde dieselben Befehle. Im
+ * Datenfile steht deshalb jeder Befehlstext nur einmal, in einer Tabelle
+ * vor den Regionen, und die Einheiten speichern nur dessen Nummer. */
+typedef struct order_entry {
+  char *text;
+  unsigned int hash;
+  int next;                     /* naechster Eintrag im selben Bucket */
+  struct order *ord[MAXLOCALES]; /* beim Lesen: geparst, je Sprache */
+} order_entry;
+
+/* beim Schreiben: die Tabellennummer jedes Befehls, in der Reihenfolge,
+ * in der write_unit() sie braucht; -1 fuer leere Befehle */
+typedef struct order_ref {
+  const struct order *ord;
+  int index;
+} order_ref;
+
+typedef struct order_table {
+  order_entry *entries;
+  int size, maxsize;
+  int *buckets;
+  int nbuckets;
+  order_ref *refs;
+  int nrefs, maxrefs, nextref;
+} order_table;
+
+static void otable_rehash(order_table *ot)
+{
+  int i;
+  ot->nbuckets = ot->nbuckets ? ot->nbuckets * 2 : 1024;
+  free(ot->buckets);
+  ot->buckets = (int *)malloc(ot->nbuckets * sizeof(int));
+  for (i = 0; i != ot->nbuckets; ++i) {
+    ot->buckets[i] = -1;
+  }
+  for (i = 0; i != ot->size; ++i) {
+    int *bucket = ot->buckets + ot->entries[i].hash % ot->nbuckets;
+    ot->entries[i].next = *bucket;
+    *bucket = i;
+  }
+}
+
+static int otable_append(order_table *ot, const char *text, unsigned int hash)
+{
+  order_entry *oe;
+  if (ot->size == ot->maxsize) {
+    ot->maxsize = ot->maxsize ? ot->maxsize * 2 : 1024;
+    ot->entries = (order_entry *)realloc(ot->entries,
+      ot->maxsize * sizeof(order_entry));
+  }
+  oe = ot->entries + ot->size;
+  oe->text = _strdup(text);
+  oe->hash = hash;
+  memset(oe->ord, 0, sizeof(oe->ord));
+  oe->next = -1;
+  return ot->size++;
+}
+
+/** returns the index of the text in the table, adding it if necessary */
+static int otable_add(order_table *ot, const char *text)
+{
+  unsigned int hash = hashstring(text);
+  int i;
+
+  if (ot->nbuckets) {
+    for (i = ot->buckets[hash % ot->nbuckets]; i >= 0; i = ot->entries[i].next) {
+      if (ot->entries[i].hash == hash && strcmp(ot->entries[i].text, text) == 0) {
+        return i;
+      }
+    }
+  }
+  i = otable_append(ot, text, hash);
+  if (ot->size > ot->nbuckets) {
+    otable_rehash(ot);
+  } else {
+    int *bucket = ot->buckets + hash % ot->nbuckets;
+    ot->entries[i].next = *bucket;
+    *bucket = i;
+  }
+  return i;
+}
+
+/** returns a copy of the i-th order, parsed once per locale */
+static order *otable_order(order_table *ot, int i, const struct locale *lang)
+{
+  order_entry *oe;
+  unsigned int l = locale_index(lang);
+  if (i < 0 || i >= ot->size) {
+    log_error("invalid order index %d\n", i);
+    return NULL;
+  }
+  oe = ot->entries + i;
+  if (oe->ord[l] == NULL) {
+    oe->ord[l] = parse_order(oe->text, lang);
+  }
+  return copy_order(oe->ord[l]);
+}
+
+static void otable_free(order_table *ot)
+{
+  int i;
+  for (i = 0; i != ot->size; ++i) {
+    int l;
+    free(ot->entries[i].text);
+    for (l = 0; l != MAXLOCALES; ++l) {
+      free_order(ot->entries[i].ord[l]);
+    }
+  }
+  free(ot->entries);
+  free(ot->buckets);
+  free(ot->refs);
+  memset(ot, 0, sizeof(order_table));
+}
+
+static void read_order_table(struct gamedata *data, order_table *ot)
+{
+  char obuf[DISPLAYSIZE];
+  int n;
+
+  READ_INT(data->store, &n);
+  while (n-- > 0) {
+    READ_STR(data->store, obuf, sizeof(obuf));
+    otable_append(ot, obuf, 0);
+  }
+}
+
+/* sammelt die Befehle, die fuer eine Einheit gespeichert werden: die alten
+ * Vorgaben und alle persistenten Befehle, die nicht von ihnen ersetzt
+ * werden. Liefert MAXPERSISTENT, wenn es zu viele sind. */
+static int saved_orders(const unit * u, const order ** olist)
+{
+  const order *ord;
+  int p = 0;
+
+  for (ord = u->old_orders; ord && p != MAXPERSISTENT; ord = ord->next) {
+    olist[p++] = ord;
+  }
+  for (ord = u->orders; ord && p != MAXPERSISTENT; ord = ord->next) {
+    if (u->old_orders && is_repeated(ord))
+      continue;                 /* has new defaults */
+    if (is_persistent(ord)) {
+      olist[p++] = ord;
+    }
+  }
+  return p;
+}
+
+static void write_order_table(struct gamedata *data, order_table *ot)
+{
+  const order *olist[MAXPERSISTENT];
+  char obuf[1024];
+  region *r;
+  int i;
+
+  for (r = regions; r; r = r->next) {
+    unit *u;
+    for (u = r->units; u; u = u->next) {
+      int n = saved_orders(u, olist);
+      if (n == MAXPERSISTENT) {
+        --n;                    /* wie in write_unit */
+      }
+      for (i = 0; i != n; ++i) {
+        order_ref *ref;
+        if (ot->nrefs == ot->maxrefs) {
+          ot->maxrefs = ot->maxrefs ? ot->maxrefs * 2 : 1024;
+          ot->refs = (order_ref *)realloc(ot->refs,
+            ot->maxrefs * sizeof(order_ref));
+        }
+        ref = ot->refs + ot->nrefs++;
+        write_order(olist[i], obuf, sizeof(obuf));
+        ref->ord = olist[i];
+        ref->index = obuf[0] ? otable_add(ot, obuf) : -1;
+      }
+    }
+  }
+  WRITE_INT(data->store, ot->size);
+  for (i = 0; i != ot->size; ++i) {
+    WRITE_STR(data->store, ot->entries[i].text);
+  }
+  WRITE_SECTION(data->store);
+}
+
 static void
 writeorder(struct gamedata *data, const struct order *ord,
   const struct locale *lang)
 {
   char obuf[1024];
+  order_table *ot = data->orders;
+
+  if (ot && ot->nextref < ot->nrefs && ot->refs[ot->nextref].ord == ord) {
+    /* schon von write_order_table() formatiert */
+    int i = ot->refs[ot->nextref++].index;
+    if (i >= 0) {
+      WRITE_INT(data->store, i + 1);
+    }
+    return;
+  }
   write_order(ord, obuf, sizeof(obuf));
-  if (obuf[0])
-    WRITE_STR(data->store, obuf);
+  if (obuf[0]) {
+    if (ot) {
+      WRITE_INT(data->store, otable_add(ot, obuf) + 1);
+    } else {
+      WRITE_STR(data->store, obuf);
+    }
+  }
+}
+
+/** reads the next order of a unit, returns false at the end of the list */
+static bool
+readorder(struct gamedata *data, const struct locale *lang, order ** ordp)
+{
+  *ordp = NULL;
+  if (data->orders) {
+    int i;
+    READ_INT(data->store, &i);
+    if (i == 0)
+      return false;
+    if (!lomem)
+      *ordp = otable_order(data->orders, i - 1, lang);
+  } else {
+    char obuf[DISPLAYSIZE];
+    READ_STR(data->store, obuf, sizeof(obuf));
+    if (obuf[0] == 0)
+      return false;
+    if (!lomem)
+      *ordp = parse_order(obuf, lang);
+  }
+  return true;
 }
 
 unit *read_unit(struct gamedata *data)
@@ -590,6 +826,7 @@ unit *read_unit(struct gamedata *data)
     u->no = n;
     uhash(u);
   } else {
+    u_setfaction(u, NULL);
     while (u->attribs)
       a_remove(&u->attribs, u->attribs);
     while (u->items)
@@ -597,7 +834,7 @@ unit *read_unit(struct gamedata *data)
     free(u->skills);
     u->skills = 0;
     u->skill_size = 0;
-    u_setfaction(u, NULL);
+    u->skill_mask = 0;
   }
 
   READ_INT(data->store, &n);
@@ -666,9 +903,6 @@ unit *read_unit(struct gamedata *data)
     set_number(u, 0);
   }
 
-  if (count_unit(u) && u->faction)
-    u->faction->no_units++;
-
   set_number(u, number);
 
   READ_INT(data->store, &n);
@@ -708,29 +942,27 @@ unit *read_unit(struct gamedata *data)
   }
   /* Persistente Befehle einlesen */
   free_orders(&u->orders);
-  READ_STR(data->store, obuf, sizeof(obuf));
   p = n = 0;
   orderp = &u->orders;
-  while (obuf[0]) {
-    if (!lomem) {
-      order *ord = parse_order(obuf, u->faction->locale);
-      if (ord != NULL) {
-        if (++n < MAXORDERS) {
-          if (!is_persistent(ord) || ++p < MAXPERSISTENT) {
-            *orderp = ord;
-            orderp = &ord->next;
-            ord = NULL;
-          } else if (p == MAXPERSISTENT) {
-            log_warning("%s had %d or more persistent orders\n", unitname(u), MAXPERSISTENT);
-          }
-        } else if (n == MAXORDERS) {
-          log_warning("%s had %d or more orders\n", unitname(u), MAXORDERS);
+  for (;;) {
+    order *ord;
+    if (!readorder(data, u->faction->locale, &ord))
+      break;
+    if (ord != NULL) {
+      if (++n < MAXORDERS) {
+        if (!is_persistent(ord) || ++p < MAXPERSISTENT) {
+          *orderp = ord;
+          orderp = &ord->next;
+          ord = NULL;
+        } else if (p == MAXPERSISTENT) {
+          log_warning("%s had %d or more persistent orders\n", unitname(u), MAXPERSISTENT);
         }
-        if (ord != NULL)
-          free_order(ord);
+      } else if (n == MAXORDERS) {
+        log_warning("%s had %d or more orders\n", unitname(u), MAXORDERS);
       }
+      if (ord != NULL)
+        free_order(ord);
     }
-    READ_STR(data->store, obuf, sizeof(obuf));
   }
   if (data->version < NOLASTORDER_VERSION) {
     order *ord;
@@ -765,13 +997,14 @@ unit *read_unit(struct gamedata *data)
   }
 
   a_read(data->store, &u->attribs, u);
+  skillcount_reset(u->faction);
   return u;
 }
 
 void write_unit(struct gamedata *data, const unit * u)
 {
-  order *ord;
-  int i, p = 0;
+  const order *olist[MAXPERSISTENT];
+  int i, p;
   unsigned int flags = u->flags & UFL_SAVEMASK;
   const race *irace = u_irace(u);
 
@@ -790,28 +1023,20 @@ void write_unit(struct gamedata *data, const unit * u)
   if (u->ship && u==ship_owner(u->ship)) flags |= UFL_OWNER;
   WRITE_INT(data->store, flags);
   WRITE_SECTION(data->store);
-  for (ord = u->old_orders; ord; ord = ord->next) {
-    if (++p < MAXPERSISTENT) {
-      writeorder(data, ord, u->faction->locale);
-    } else {
-      log_error("%s had %d or more persistent orders\n", unitname(u), MAXPERSISTENT);
-      break;
-    }
+  p = saved_orders(u, olist);
+  if (p == MAXPERSISTENT) {
+    log_error("%s had %d or more persistent orders\n", unitname(u), MAXPERSISTENT);
+    --p;
   }
-  for (ord = u->orders; ord; ord = ord->next) {
-    if (u->old_orders && is_repeated(ord))
-      continue;                 /* has new defaults */
-    if (is_persistent(ord)) {
-      if (++p < MAXPERSISTENT) {
-        writeorder(data, ord, u->faction->locale);
-      } else {
-        log_error("%s had %d or more persistent orders\n", unitname(u), MAXPERSISTENT);
-        break;
-      }
-    }
+  for (i = 0; i != p; ++i) {
+    writeorder(data, olist[i], u->faction->locale);
+  }
+  /* write an empty entry to terminate the list */
+  if (data->orders) {
+    WRITE_INT(data->store, 0);
+  } else {
+    WRITE_STR(data->store, "");
   }
-  /* write an empty string to terminate the list */
-  WRITE_STR(data->store, "");
   WRITE_SECTION(data->store);
 
   assert(u_race(u));
@@ -1408,8 +1633,9 @@ int readgame(const char *filename, int backup)
   int rmax = maxregions;
   char path[MAX_PATH];
   char name[DISPLAYSIZE];
-  const struct building_type *bt_lighthouse = bt_find("lighthouse");
+  const struct building_type *bt_lighthouse = bt_get(BT_LIGHTHOUSE);
   gamedata gdata = { 0 };
+  order_table otable = { 0 };
   storage store;
   FILE *F;
 
@@ -1544,6 +1770,11 @@ int readgame(const char *filename, int backup)
     }
   }
 
+  if (gdata.version >= ORDERTABLE_VERSION) {
+    read_order_table(&gdata, &otable);
+    gdata.orders = &otable;
+  }
+
   /* Regionen */
 
   READ_INT(&store, &nread);
@@ -1675,6 +1906,7 @@ int readgame(const char *filename, int backup)
   read_borders(&store);
 
   binstore_done(&store);
+  otable_free(&otable);
 
   /* Unaufgeloeste Zeiger initialisieren */
   log_printf(stdout, "fixing unresolved references.\n");
@@ -1690,6 +1922,7 @@ int readgame(const char *filename, int backup)
   }
   log_printf(stdout, "marking factions as alive.\n");
   for (f = factions; f; f = f->next) {
+    recount_faction(f);
     if (f->flags & FFL_NPC) {
       f->alive = 1;
       if (f->no == 0) {
@@ -1738,6 +1971,7 @@ int writegame(const char *filename)
   plane *pl;
   char path[MAX_PATH];
   gamedata gdata;
+  order_table otable = { 0 };
   storage store;
   FILE *F;
 
@@ -1764,6 +1998,7 @@ int writegame(const char *filename)
   gdata.store = &store;
   gdata.encoding = enc_gamedata;
   gdata.version = RELEASE_VERSION;
+  gdata.orders = NULL;
   n = STREAM_VERSION;
   fwrite(&gdata.version, sizeof(int), 1, F);
   fwrite(&n, sizeof(int), 1, F);
@@ -1828,6 +2063,10 @@ int writegame(const char *filename)
     WRITE_SECTION(&store);
   }
 
+  /* Write orders */
+  write_order_table(&gdata, &otable);
+  gdata.orders = &otable;
+
   /* Write regions */
 
   n = listlen(regions);
@@ -1888,6 +2127,7 @@ int writegame(const char *filename)
   WRITE_SECTION(&store);
 
   binstore_done(&store);
+  otable_free(&otable);
 
   log_printf(stdout, "\nOk.\n");
   return 0;
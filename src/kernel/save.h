@@ -26,6 +26,7 @@ extern "C" {
     struct storage *store;
     int version;
     int encoding;
+    struct order_table *orders; /* shared order texts, or NULL */
   } gamedata;
 
 #define MAX_INPUT_SIZE	DISPLAYSIZE*2
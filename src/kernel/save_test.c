@@ -0,0 +1,218 @@
+#include <platform.h>
+
+#include <kernel/types.h>
+#include <kernel/config.h>
+#include <kernel/faction.h>
+#include <kernel/order.h>
+#include <kernel/region.h>
+#include <kernel/save.h>
+#include <kernel/unit.h>
+#include <util/base36.h>
+#include <util/lists.h>
+
+#include <CuTest.h>
+#include <tests.h>
+
+#include <stdio.h>
+
+static const char *orders_file = "orders.test";
+
+static void write_orders(const char *text)
+{
+  FILE *F = fopen(orders_file, "wb");
+  fputs(text, F);
+  fclose(F);
+}
+
+static int count_orders(const unit *u)
+{
+  const order *ord;
+  int n = 0;
+  for (ord = u->orders; ord; ord = ord->next) {
+    ++n;
+  }
+  return n;
+}
+
+static void test_readorders(CuTest * tc)
+{
+  faction *f1, *f2;
+  unit *u1, *u2, *u3;
+  region *r;
+  char text[1024];
+
+  test_cleanup();
+  test_create_locale();
+  test_create_world();
+  r = findregion(0, 0);
+  f1 = test_create_faction(0);
+  f2 = test_create_faction(0);
+  faction_setpassword(f1, "secret");
+  faction_setpassword(f2, "secret");
+  u1 = test_create_unit(f1, r);
+  u2 = test_create_unit(f1, r);
+  u3 = test_create_unit(f2, r);
+  addlist(&u3->orders, create_order(K_WORK, f2->locale, 0));
+
+  sprintf(text, "ERESSEA %s \"secret\"\n"
+    "EINHEIT %s\nARBEITEN\nBENENNEN EINHEIT Hugo\n"
+    "EINHEIT %s\nARBEITEN\n"
+    "EINHEIT %s\nBEWACHEN\nBEWACHEN\n"
+    "NAECHSTER\n"
+    "EINHEIT %s\nBEWACHEN\n"
+    "ERESSEA %s \"wrong\"\n"
+    "EINHEIT %s\nBEWACHEN\nBEWACHEN\nBEWACHEN\n"
+    "NAECHSTER\n",
+    itoa36(f1->no), itoa36(u1->no), itoa36(u2->no), itoa36(u2->no),
+    itoa36(u1->no), itoa36(f2->no), itoa36(u3->no));
+  write_orders(text);
+
+  CuAssertIntEquals(tc, 0, readorders(orders_file));
+  CuAssertIntEquals(tc, 2, count_orders(u1));
+  CuAssertIntEquals(tc, K_WORK, get_keyword(u1->orders));
+  /* the last submission for a unit wins */
+  CuAssertIntEquals(tc, 2, count_orders(u2));
+  CuAssertIntEquals(tc, K_GUARD, get_keyword(u2->orders));
+  /* a wrong password leaves the orders alone */
+  CuAssertIntEquals(tc, 1, count_orders(u3));
+  CuAssertIntEquals(tc, K_WORK, get_keyword(u3->orders));
+  CuAssertIntEquals(tc, global.data_turn + 1, f1->lastorders);
+  CuAssertTrue(tc, f2->lastorders != global.data_turn + 1);
+  remove(orders_file);
+}
+
+static void test_readorders_foreign_unit(CuTest * tc)
+{
+  faction *f1, *f2;
+  unit *u1, *u2;
+  region *r;
+  char text[1024];
+
+  test_cleanup();
+  test_create_locale();
+  test_create_world();
+  r = findregion(0, 0);
+  f1 = test_create_faction(0);
+  f2 = test_create_faction(0);
+  faction_setpassword(f1, "secret");
+  u1 = test_create_unit(f1, r);
+  u2 = test_create_unit(f2, r);
+
+  /* orders for a unit of another faction are skipped up to the next unit */
+  sprintf(text, "ERESSEA %s secret\n"
+    "EINHEIT %s\nARBEITEN\nARBEITEN\n"
+    "EINHEIT %s\nARBEITEN\n",
+    itoa36(f1->no), itoa36(u2->no), itoa36(u1->no));
+  write_orders(text);
+
+  CuAssertIntEquals(tc, 0, readorders(orders_file));
+  CuAssertIntEquals(tc, 0, count_orders(u2));
+  CuAssertIntEquals(tc, 1, count_orders(u1));
+  remove(orders_file);
+}
+
+static void test_save_orders(CuTest * tc)
+{
+  faction *f;
+  unit *u1, *u2;
+  region *r;
+  int no1, no2;
+  char cmd[64], path[256];
+
+  test_cleanup();
+  test_create_locale();
+  test_create_world();
+  r = findregion(0, 0);
+  f = test_create_faction(0);
+  faction_setbanner(f, "");
+  u1 = test_create_unit(f, r);
+  u2 = test_create_unit(f, r);
+  no1 = u1->no;
+  no2 = u2->no;
+  addlist(&u1->orders, parse_order("@BENENNEN EINHEIT Hugo", f->locale));
+  addlist(&u1->orders, parse_order("NACH O W", f->locale));
+  addlist(&u2->orders, parse_order("@BENENNEN EINHEIT Hugo", f->locale));
+  addlist(&u2->orders, parse_order("ARBEITEN", f->locale));
+
+  CuAssertIntEquals(tc, 0, writegame("test.dat"));
+  free_gamedata();
+  CuAssertIntEquals(tc, 0, readgame("test.dat", 0));
+
+  u1 = findunit(no1);
+  u2 = findunit(no2);
+  CuAssertPtrNotNull(tc, u1);
+  CuAssertPtrNotNull(tc, u2);
+  /* only persistent and repeated orders are saved */
+  CuAssertPtrNotNull(tc, u1->orders);
+  CuAssertPtrEquals(tc, 0, u1->orders->next);
+  CuAssertStrEquals(tc, "@BENENNEN EINHEIT Hugo",
+    write_order(u1->orders, cmd, sizeof(cmd)));
+  CuAssertPtrNotNull(tc, u2->orders);
+  CuAssertStrEquals(tc, "@BENENNEN EINHEIT Hugo",
+    write_order(u2->orders, cmd, sizeof(cmd)));
+  CuAssertPtrNotNull(tc, u2->orders->next);
+  CuAssertStrEquals(tc, "ARBEITEN", write_order(u2->orders->next, cmd, sizeof(cmd)));
+  /* both units share the order that was stored once */
+  CuAssertPtrEquals(tc, u1->orders->data, u2->orders->data);
+  sprintf(path, "%s/test.dat", datapath());
+  remove(path);
+}
+
+/* the same order text, read for factions of two languages in turn */
+static void test_save_orders_locales(CuTest * tc)
+{
+  faction *f1, *f2;
+  unit *u1, *u2, *u3;
+  struct locale *lang;
+  region *r;
+  int no1, no2, no3;
+  char cmd[64], path[256];
+
+  test_cleanup();
+  test_create_locale();
+  lang = test_create_named_locale("en");
+  test_create_world();
+  r = findregion(0, 0);
+  f1 = test_create_faction(0);
+  f2 = test_create_faction(0);
+  f2->locale = lang;
+  faction_setbanner(f1, "");
+  faction_setbanner(f2, "");
+  u1 = test_create_unit(f1, r);
+  u2 = test_create_unit(f2, r);
+  u3 = test_create_unit(f1, r);
+  no1 = u1->no;
+  no2 = u2->no;
+  no3 = u3->no;
+  addlist(&u1->orders, parse_order("@BENENNEN EINHEIT Hugo", f1->locale));
+  addlist(&u2->orders, parse_order("@BENENNEN EINHEIT Hugo", lang));
+  addlist(&u3->orders, parse_order("@BENENNEN EINHEIT Hugo", f1->locale));
+
+  CuAssertIntEquals(tc, 0, writegame("test.dat"));
+  free_gamedata();
+  CuAssertIntEquals(tc, 0, readgame("test.dat", 0));
+
+  u1 = findunit(no1);
+  u2 = findunit(no2);
+  u3 = findunit(no3);
+  CuAssertPtrNotNull(tc, u1);
+  CuAssertPtrNotNull(tc, u2);
+  CuAssertPtrNotNull(tc, u3);
+  CuAssertPtrEquals(tc, lang, (struct locale *)u2->faction->locale);
+  CuAssertStrEquals(tc, "@BENENNEN EINHEIT Hugo",
+    write_order(u2->orders, cmd, sizeof(cmd)));
+  CuAssertPtrEquals(tc, u1->orders->data, u3->orders->data);
+  CuAssertTrue(tc, u1->orders->data != u2->orders->data);
+  sprintf(path, "%s/test.dat", datapath());
+  remove(path);
+}
+
+CuSuite *get_save_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_readorders);
+  SUITE_ADD_TEST(suite, test_readorders_foreign_unit);
+  SUITE_ADD_TEST(suite, test_save_orders);
+  SUITE_ADD_TEST(suite, test_save_orders_locales);
+  return suite;
+}
@@ -199,7 +199,7 @@ void remove_ship(ship ** slist, ship * sh)
   region *r = sh->region;
   unit *u = r->units;
 
-  handle_event(sh->attribs, "destroy", sh);
+  handle_event_id(sh->attribs, EV_DESTROY, sh);
   while (u) {
     if (u->ship == sh) {
       leave_ship(u);
@@ -77,8 +77,13 @@ bool skill_enabled[MAXSKILLS];
 
 const char *skillname(skill_t sk, const struct locale *lang)
 {
+  static unsigned int ids[MAXSKILLS];
+
   if (skill_enabled[sk]) {
-    return locale_string(lang, mkname("skill", skillnames[sk]));
+    if (!ids[sk]) {
+      ids[sk] = locale_key(mkname("skill", skillnames[sk]));
+    }
+    return locale_string_id(lang, ids[sk]);
   }
   return NULL;
 }
@@ -300,6 +305,7 @@ int skill_weeks(int level)
 
 void reduce_skill(unit * u, skill * sv, unsigned int weeks)
 {
+  skillcount_change(u, sv, -u->number);
   sv->weeks += weeks;
   while (sv->level > 0 && sv->level * 2 + 1 < sv->weeks) {
     sv->weeks -= sv->level;
@@ -309,6 +315,7 @@ void reduce_skill(unit * u, skill * sv, unsigned int weeks)
     /* reroll */
     sv->weeks = (unsigned char)skill_weeks(sv->level);
   }
+  skillcount_change(u, sv, u->number);
 }
 
 int skill_compare(const skill * sk, const skill * sc)
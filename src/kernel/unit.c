@@ -344,7 +344,7 @@ int remove_unit(unit ** ulist, unit * u)
   int result;
 
   assert(ufindhash(u->no));
-  handle_event(u->attribs, "destroy", u);
+  handle_event_id(u->attribs, EV_DESTROY, u);
 
   result = gift_items(u, GIFT_SELF | GIFT_FRIENDS | GIFT_PEASANTS);
   if (result != 0) {
@@ -713,12 +713,9 @@ int u_geteffstealth(const struct unit *u)
 int get_level(const unit * u, skill_t id)
 {
   if (skill_enabled[id]) {
-    skill *sv = u->skills;
-    while (sv != u->skills + u->skill_size) {
-      if (sv->id == id) {
-        return sv->level;
-      }
-      ++sv;
+    skill *sv = get_skill(u, id);
+    if (sv) {
+      return sv->level;
     }
   }
   return 0;
@@ -726,7 +723,7 @@ int get_level(const unit * u, skill_t id)
 
 void set_level(unit * u, skill_t sk, int value)
 {
-  skill *sv = u->skills;
+  skill *sv;
 
   if (!skill_enabled[sk])
     return;
@@ -735,14 +732,14 @@ void set_level(unit * u, skill_t sk, int value)
     remove_skill(u, sk);
     return;
   }
-  while (sv != u->skills + u->skill_size) {
-    if (sv->id == sk) {
-      sk_set(sv, value);
-      return;
-    }
-    ++sv;
+  sv = get_skill(u, sk);
+  if (sv) {
+    skillcount_change(u, sv, -u->number);
+  } else {
+    sv = add_skill(u, sk);
   }
-  sk_set(add_skill(u, sk), value);
+  sk_set(sv, value);
+  skillcount_change(u, sv, u->number);
 }
 
 static int leftship_age(struct attrib *a)
@@ -980,8 +977,11 @@ void transfermen(unit * u, unit * u2, int n)
       if (level) {
         if (sn == NULL)
           sn = add_skill(u2, sk);
+        else
+          skillcount_change(u2, sn, -u2->number);
         sn->level = (unsigned char)level;
         sn->weeks = (unsigned char)weeks;
+        skillcount_change(u2, sn, u2->number);
         assert(sn->weeks > 0 && sn->weeks <= sn->level * 2 + 1);
         assert(u2->number != 0 || (sn->level == sv->level
             && sn->weeks == sv->weeks));
@@ -1075,8 +1075,7 @@ void u_setfaction(unit * u, faction * f)
     return;
   if (u->faction) {
     set_number(u, 0);
-    if (count_unit(u))
-      --u->faction->no_units;
+    update_faction_counts(u, -1);
     join_group(u, NULL);
     free_orders(&u->orders);
     set_order(&u->thisorder, NULL);
@@ -1099,12 +1098,11 @@ void u_setfaction(unit * u, faction * f)
     u->nextF = NULL;
 
   u->faction = f;
+  update_faction_counts(u, 1);
   if (u->region)
     update_interval(f, u->region);
   if (cnt && f) {
     set_number(u, cnt);
-    if (count_unit(u))
-      ++f->no_units;
   }
 }
 
@@ -1114,63 +1112,83 @@ void set_number(unit * u, int count)
   assert(count >= 0);
   assert(count <= UNIT_MAXSIZE);
 
+  update_faction_counts(u, -1);
   if (count == 0) {
     u->flags &= ~(UFL_HERO);
   }
-  if (u->faction && playerrace(u_race(u))) {
-    u->faction->num_people += count - u->number;
+  if (u->faction) {
+    const skill *sv;
+    for (sv = u->skills; sv != u->skills + u->skill_size; ++sv) {
+      skillcount_change(u, sv, count - u->number);
+    }
   }
   u->number = (unsigned short)count;
+  update_faction_counts(u, 1);
 }
 
 bool learn_skill(unit * u, skill_t sk, double chance)
 {
-  skill *sv = u->skills;
+  skill *sv;
   if (chance < 1.0 && rng_int() % 10000 >= chance * 10000)
     return false;
-  while (sv != u->skills + u->skill_size) {
+  sv = get_skill(u, sk);
+  if (sv) {
     assert(sv->weeks > 0);
-    if (sv->id == sk) {
-      if (sv->weeks <= 1) {
-        sk_set(sv, sv->level + 1);
-      } else {
-        sv->weeks--;
-      }
-      return true;
+    if (sv->weeks <= 1) {
+      skillcount_change(u, sv, -u->number);
+      sk_set(sv, sv->level + 1);
+      skillcount_change(u, sv, u->number);
+    } else {
+      sv->weeks--;
     }
-    ++sv;
+    return true;
   }
   sv = add_skill(u, sk);
   sk_set(sv, 1);
+  skillcount_change(u, sv, u->number);
   return true;
 }
 
+/* u->skills is sorted by id and grows in blocks of SKILL_BLOCK entries.
+ * the position of a skill is the number of bits below it in u->skill_mask. */
+#define SKILL_BLOCK 4
+
+static int skill_index(unsigned int mask, skill_t sk)
+{
+  unsigned int v = mask & ((1u << sk) - 1);
+  v = v - ((v >> 1) & 0x55555555);
+  v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+  return (int)((((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+}
+
 void remove_skill(unit * u, skill_t sk)
 {
-  skill *sv = u->skills;
-  for (sv = u->skills; sv != u->skills + u->skill_size; ++sv) {
-    if (sv->id == sk) {
-      skill *sl = u->skills + u->skill_size - 1;
-      if (sl != sv) {
-        *sv = *sl;
-      }
-      --u->skill_size;
-      return;
-    }
+  skill *sv = get_skill(u, sk);
+  if (sv) {
+    skill *end = u->skills + u->skill_size;
+    skillcount_change(u, sv, -u->number);
+    memmove(sv, sv + 1, (end - sv - 1) * sizeof(skill));
+    --u->skill_size;
+    u->skill_mask &= ~(1u << sk);
   }
 }
 
 skill *add_skill(unit * u, skill_t id)
 {
-  skill *sv = u->skills;
-#ifndef NDEBUG
-  for (sv = u->skills; sv != u->skills + u->skill_size; ++sv) {
-    assert(sv->id != id);
+  skill *sv;
+  int i;
+
+  assert(id >= 0 && id < MAXSKILLS && MAXSKILLS <= 32);
+  assert((u->skill_mask & (1u << id)) == 0);
+  if (u->skill_size % SKILL_BLOCK == 0) {
+    u->skills =
+      realloc(u->skills, (u->skill_size + SKILL_BLOCK) * sizeof(skill));
   }
-#endif
+  i = skill_index(u->skill_mask, id);
+  sv = u->skills + i;
+  memmove(sv + 1, sv, (u->skill_size - i) * sizeof(skill));
   ++u->skill_size;
-  u->skills = realloc(u->skills, u->skill_size * sizeof(skill));
-  sv = (u->skills + u->skill_size - 1);
+  u->skill_mask |= (1u << id);
   sv->level = (unsigned char)0;
   sv->weeks = (unsigned char)1;
   sv->old = (unsigned char)0;
@@ -1180,25 +1198,16 @@ skill *add_skill(unit * u, skill_t id)
 
 skill *get_skill(const unit * u, skill_t sk)
 {
-  skill *sv = u->skills;
-  while (sv != u->skills + u->skill_size) {
-    if (sv->id == sk)
-      return sv;
-    ++sv;
+  if ((unsigned int)sk < MAXSKILLS && (u->skill_mask & (1u << sk))) {
+    return u->skills + skill_index(u->skill_mask, sk);
   }
   return NULL;
 }
 
 bool has_skill(const unit * u, skill_t sk)
 {
-  skill *sv = u->skills;
-  while (sv != u->skills + u->skill_size) {
-    if (sv->id == sk) {
-      return (sv->level > 0);
-    }
-    ++sv;
-  }
-  return false;
+  skill *sv = get_skill(u, sk);
+  return sv && sv->level > 0;
 }
 
 static int item_modification(const unit * u, skill_t sk, int val)
@@ -1557,14 +1566,7 @@ int maxheroes(const struct faction *f)
 
 int countheroes(const struct faction *f)
 {
-  const unit *u = f->units;
-  int n = 0;
-
-  while (u) {
-    if (fval(u, UFL_HERO))
-      n += u->number;
-    u = u->nextF;
-  }
+  int n = f->num_heroes;
 #ifdef DEBUG_MAXHEROES
   int m = maxheroes(f);
   if (n > m) {
@@ -1574,6 +1576,95 @@ int countheroes(const struct faction *f)
   return n;
 }
 
+static bool is_migrant(const unit * u)
+{
+  const race *rc = u_race(u);
+  return rc != u->faction->race && rc != new_race[RC_ILLUSION]
+    && rc != new_race[RC_SPELL] && playerrace(rc)
+    && !is_cursed(u->attribs, C_SLAVE, 0);
+}
+
+/** keeps the number of units, people, migrants and heroes in struct
+ * faction. call with -1 before and with +1 after changing the faction,
+ * size, race or hero status of a unit. Whether a unit counts as migrant is
+ * remembered in UFL_MIGRANT, so a slavery curse that ends in between does
+ * not upset the count.
+ */
+void update_faction_counts(unit * u, int sign)
+{
+  faction *f = u->faction;
+  int n;
+
+  if (f == NULL || u->race_ == NULL)
+    return;
+  if (count_unit(u))
+    f->no_units += sign;
+  if (sign > 0) {
+    if (is_migrant(u))
+      fset(u, UFL_MIGRANT);
+    else
+      freset(u, UFL_MIGRANT);
+  }
+  n = sign * u->number;
+  if (playerrace(u_race(u)))
+    f->num_people += n;
+  if (fval(u, UFL_MIGRANT))
+    f->num_migrants += n;
+  if (fval(u, UFL_HERO))
+    f->num_heroes += n;
+}
+
+void recount_faction(faction * f)
+{
+  unit *u;
+
+  f->no_units = 0;
+  f->num_people = 0;
+  f->num_migrants = 0;
+  f->num_heroes = 0;
+  for (u = f->units; u; u = u->nextF) {
+    assert(u->faction == f);
+    update_faction_counts(u, 1);
+  }
+}
+
+/** checks the counters that are kept in struct faction. Migrants are
+ * counted again, because a slavery curse may have ended during the turn.
+ */
+void verify_faction_counts(void)
+{
+  faction *f;
+
+  for (f = factions; f; f = f->next) {
+#ifndef NDEBUG
+    int people = 0, migrants = 0, heroes = 0, units = 0;
+    unit *u;
+    for (u = f->units; u; u = u->nextF) {
+      if (playerrace(u_race(u)))
+        people += u->number;
+      if (fval(u, UFL_MIGRANT))
+        migrants += u->number;
+      if (fval(u, UFL_HERO))
+        heroes += u->number;
+      if (count_unit(u))
+        ++units;
+    }
+    if (people != f->num_people || migrants != f->num_migrants
+      || heroes != f->num_heroes || units != f->no_units) {
+      log_error("counters for %s are wrong: %d people, %d migrants, "
+        "%d heroes, %d units should be %d, %d, %d, %d.\n", factionid(f),
+        f->num_people, f->num_migrants, f->num_heroes, f->no_units,
+        people, migrants, heroes, units);
+    }
+    assert(people == f->num_people);
+    assert(migrants == f->num_migrants);
+    assert(heroes == f->num_heroes);
+    assert(units == f->no_units);
+#endif
+    recount_faction(f);
+  }
+}
+
 const char *unit_getname(const unit * u)
 {
   return (const char *)u->name;
@@ -1747,7 +1838,9 @@ const struct race *u_race(const struct unit *u)
 void u_setrace(struct unit *u, const struct race *rc)
 {
   assert(rc);
+  update_faction_counts(u, -1);
   u->race_ = rc;
+  update_faction_counts(u, 1);
 }
 
 void unit_add_spell(unit * u, sc_mage * m, struct spell * sp, int level)
@@ -50,6 +50,7 @@ extern "C" {
 /* warning: von 512/1024 gewechslet, wegen konflikt mit NEW_FOLLOW */
 #define UFL_LOCKED        (1<<16)       /* Einheit kann keine Personen aufnehmen oder weggeben, nicht rekrutieren. */
 #define UFL_FLEEING       (1<<17)       /* unit was in a battle, fleeing. */
+#define UFL_MIGRANT       (1<<18)       /* wird in faction::num_migrants gezhlt */
 #define UFL_STORM         (1<<19)       /* Kapitn war in einem Sturm */
 #define UFL_FOLLOWING     (1<<20)
 #define UFL_FOLLOWED      (1<<21)
@@ -70,6 +71,9 @@ extern "C" {
 #define UNIT_MAXSIZE 50000
   extern int maxheroes(const struct faction *f);
   extern int countheroes(const struct faction *f);
+  extern void update_faction_counts(struct unit *u, int sign);
+  extern void recount_faction(struct faction *f);
+  extern void verify_faction_counts(void);
 
   typedef struct reservation {
     struct reservation *next;
@@ -94,7 +98,8 @@ extern "C" {
 
     /* skill data */
     short skill_size;
-    struct skill *skills;
+    unsigned int skill_mask;    /* bit sk is set if skills has an entry for sk */
+    struct skill *skills;       /* sorted by id */
     struct item *items;
     reservation *reservations;
 
@@ -0,0 +1,160 @@
+#include <platform.h>
+
+#include <kernel/types.h>
+#include <kernel/config.h>
+#include <kernel/faction.h>
+#include <kernel/magic.h>
+#include <kernel/race.h>
+#include <kernel/region.h>
+#include <kernel/skill.h>
+#include <kernel/unit.h>
+
+#include <CuTest.h>
+#include <tests.h>
+
+static void test_skills_sorted(CuTest * tc)
+{
+  unit *u;
+  skill *sv;
+
+  test_cleanup();
+  test_create_world();
+  skill_enabled[SK_ALCHEMY] = true;
+  skill_enabled[SK_MAGIC] = true;
+  skill_enabled[SK_SPY] = true;
+  skill_enabled[SK_TACTICS] = true;
+  skill_enabled[SK_STAMINA] = true;
+  u = test_create_unit(test_create_faction(0), findregion(0, 0));
+  set_level(u, SK_STAMINA, 2);
+  set_level(u, SK_ALCHEMY, 3);
+  set_level(u, SK_MAGIC, 1);
+  set_level(u, SK_TACTICS, 4);
+  set_level(u, SK_SPY, 5);
+  CuAssertIntEquals(tc, 5, u->skill_size);
+  for (sv = u->skills + 1; sv != u->skills + u->skill_size; ++sv) {
+    CuAssertTrue(tc, sv[-1].id < sv->id);
+  }
+  CuAssertIntEquals(tc, 3, get_level(u, SK_ALCHEMY));
+  CuAssertIntEquals(tc, 5, get_level(u, SK_SPY));
+  CuAssertIntEquals(tc, 0, get_level(u, SK_MELEE));
+  CuAssertPtrEquals(tc, 0, get_skill(u, SK_MELEE));
+  CuAssertPtrEquals(tc, 0, get_skill(u, NOSKILL));
+  CuAssertTrue(tc, has_skill(u, SK_TACTICS));
+
+  remove_skill(u, SK_MAGIC);
+  CuAssertIntEquals(tc, 4, u->skill_size);
+  CuAssertTrue(tc, !has_skill(u, SK_MAGIC));
+  CuAssertIntEquals(tc, 4, get_level(u, SK_TACTICS));
+  CuAssertIntEquals(tc, 2, get_level(u, SK_STAMINA));
+  set_level(u, SK_TACTICS, 0);
+  CuAssertIntEquals(tc, 3, u->skill_size);
+  CuAssertIntEquals(tc, SK_ALCHEMY, u->skills[0].id);
+  CuAssertIntEquals(tc, SK_SPY, u->skills[1].id);
+  CuAssertIntEquals(tc, SK_STAMINA, u->skills[2].id);
+}
+
+static int scan_skill(const faction * f, skill_t sk)
+{
+  const unit *u;
+  int n = 0;
+  for (u = f->units; u; u = u->nextF) {
+    if (has_skill(u, sk) && !is_familiar(u)) {
+      n += u->number;
+    }
+  }
+  return n;
+}
+
+static void test_count_skill(CuTest * tc)
+{
+  faction *f1, *f2;
+  unit *u1, *u2, *u3;
+  region *r;
+
+  test_cleanup();
+  test_create_world();
+  skill_enabled[SK_MAGIC] = true;
+  skill_enabled[SK_ALCHEMY] = true;
+  r = findregion(0, 0);
+  f1 = test_create_faction(0);
+  f2 = test_create_faction(0);
+  u1 = test_create_unit(f1, r);
+  u2 = test_create_unit(f1, r);
+  u3 = test_create_unit(f2, r);
+  scale_number(u1, 3);
+  scale_number(u2, 2);
+  set_level(u1, SK_ALCHEMY, 1);
+  CuAssertIntEquals(tc, 3, count_skill(f1, SK_ALCHEMY));
+  CuAssertIntEquals(tc, 0, count_skill(f1, SK_MAGIC));
+
+  /* the cached counts follow every change */
+  set_level(u2, SK_ALCHEMY, 2);
+  CuAssertIntEquals(tc, 5, count_skill(f1, SK_ALCHEMY));
+  learn_skill(u2, SK_MAGIC, 1.0);
+  CuAssertIntEquals(tc, 2, count_skill(f1, SK_MAGIC));
+  scale_number(u1, 5);
+  CuAssertIntEquals(tc, 7, count_skill(f1, SK_ALCHEMY));
+  u_setfaction(u1, f2);
+  CuAssertIntEquals(tc, 2, count_skill(f1, SK_ALCHEMY));
+  CuAssertIntEquals(tc, 5, count_skill(f2, SK_ALCHEMY));
+  remove_skill(u2, SK_ALCHEMY);
+  CuAssertIntEquals(tc, 0, count_skill(f1, SK_ALCHEMY));
+  set_level(u3, SK_MAGIC, 3);
+  create_newfamiliar(u1, u3);
+  CuAssertIntEquals(tc, scan_skill(f2, SK_MAGIC), count_skill(f2, SK_MAGIC));
+  CuAssertIntEquals(tc, scan_skill(f2, SK_ALCHEMY), count_skill(f2, SK_ALCHEMY));
+  CuAssertIntEquals(tc, scan_skill(f1, SK_MAGIC), count_skill(f1, SK_MAGIC));
+}
+
+static void test_faction_counts(CuTest * tc)
+{
+  faction *f1, *f2;
+  unit *u1, *u2;
+  region *r;
+  race *rc;
+
+  test_cleanup();
+  test_create_world();
+  r = findregion(0, 0);
+  rc = test_create_race("elf");
+  f1 = test_create_faction(rc_find("human"));
+  f2 = test_create_faction(rc);
+  u1 = test_create_unit(f1, r);
+  u2 = test_create_unit(f1, r);
+  scale_number(u1, 5);
+  scale_number(u2, 3);
+  CuAssertIntEquals(tc, 8, count_all(f1));
+  CuAssertIntEquals(tc, 0, count_migrants(f1));
+
+  u_setrace(u2, rc);
+  CuAssertIntEquals(tc, 3, count_migrants(f1));
+  scale_number(u2, 4);
+  CuAssertIntEquals(tc, 4, count_migrants(f1));
+  CuAssertIntEquals(tc, 9, count_all(f1));
+
+  update_faction_counts(u1, -1);
+  fset(u1, UFL_HERO);
+  update_faction_counts(u1, 1);
+  CuAssertIntEquals(tc, 5, countheroes(f1));
+
+  u_setfaction(u2, f2);
+  CuAssertIntEquals(tc, 0, count_migrants(f1));
+  CuAssertIntEquals(tc, 0, count_migrants(f2));
+  CuAssertIntEquals(tc, 5, count_all(f1));
+  CuAssertIntEquals(tc, 4, count_all(f2));
+  verify_faction_counts();
+
+  set_number(u1, 0);
+  CuAssertIntEquals(tc, 0, countheroes(f1));
+  CuAssertIntEquals(tc, 0, count_all(f1));
+  verify_faction_counts();
+}
+
+CuSuite *get_unit_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_skills_sorted);
+  SUITE_ADD_TEST(suite, test_count_skill);
+  SUITE_ADD_TEST(suite, test_faction_counts);
+  return suite;
+}
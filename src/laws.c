@@ -510,23 +510,14 @@ static void peasants(region * r)
       glueck = a->data.i * 1000;
     }
 
-    for (n = peasants; n; --n) {
-      int chances = 0;
-
-      if (glueck > 0) {
-        --glueck;
-        chances += PEASANTLUCK;
-      }
-
-      while (chances--) {
-        if (rng_int() % 10000 < PEASANTGROWTH) {
-          /* Only raise with 75% chance if peasants have
-           * reached 90% of maxpopulation */
-          if (peasants / (float)maxp < 0.9 || chance(PEASANTFORCE)) {
-            ++births;
-          }
-        }
+    if (glueck > 0) {
+      /* Jeder der ersten glueck Bauern hat PEASANTLUCK Versuche. Only
+       * raise with 75% chance if peasants have reached 90% of maxpopulation */
+      double p = PEASANTGROWTH / 10000.0;
+      if (!(peasants / (float)maxp < 0.9)) {
+        p *= PEASANTFORCE;
       }
+      births += binomialvariate(MIN(peasants, glueck) * PEASANTLUCK, p);
     }
     peasants += births;
   }
@@ -556,63 +547,24 @@ static void peasants(region * r)
 
 /* ------------------------------------------------------------- */
 
+/* Was in eine Region einwandert, wird erst gesammelt und nach dem
+ * Wachstum aller Regionen verteilt. So hngt das Ergebnis nicht von der
+ * Auswertungsreihenfolge der Regionen ab. Index ist region::index. */
 typedef struct migration {
-  struct migration *next;
-  region *r;
   int horses;
-  int trees;
+  int seeds;
 } migration;
 
-#define MSIZE 1023
-migration *migrants[MSIZE];
-migration *free_migrants;
-
-static migration *get_migrants(region * r)
-{
-  int key = reg_hashkey(r);
-  int index = key % MSIZE;
-  migration *m = migrants[index];
-  while (m && m->r != r)
-    m = m->next;
-  if (m == NULL) {
-    /* Es gibt noch keine Migration. Also eine erzeugen
-     */
-    m = free_migrants;
-    if (!m)
-      m = calloc(1, sizeof(migration));
-    else {
-      free_migrants = free_migrants->next;
-      m->horses = 0;
-      m->trees = 0;
-    }
-    m->r = r;
-    m->next = migrants[index];
-    migrants[index] = m;
-  }
-  return m;
-}
+static migration *migrants;
 
 static void migrate(region * r)
 {
-  int key = reg_hashkey(r);
-  int index = key % MSIZE;
-  migration **hp = &migrants[index];
-  fset(r, RF_MIGRATION);
-  while (*hp && (*hp)->r != r)
-    hp = &(*hp)->next;
-  if (*hp) {
-    migration *m = *hp;
+  migration *m = migrants + r->index;
+  if (m->horses) {
     rsethorses(r, rhorses(r) + m->horses);
-    /* Was macht das denn hier?
-     * Baumwanderung wird in trees() gemacht.
-     * wer fragt das? Die Baumwanderung war abhngig von der
-     * Auswertungsreihenfolge der regionen,
-     * das hatte ich gendert. jemand hat es wieder gelscht, toll.
-     * ich habe es wieder aktiviert, mu getestet werden.
-     */
-    *hp = m->next;
-    m->next = free_migrants;
-    free_migrants = m;
+  }
+  if (m->seeds) {
+    rsettrees(r, TREE_SEED, rtrees(r, TREE_SEED) + m->seeds);
   }
 }
 
@@ -645,10 +597,8 @@ static void horses(region * r)
     }
   }
 
-  /* Pferde wandern in Nachbarregionen.
-   * Falls die Nachbarregion noch berechnet
-   * werden mu, wird eine migration-Struktur gebildet,
-   * die dann erst in die Berechnung der Nachbarstruktur einfliet.
+  /* Pferde wandern in Nachbarregionen. Sie kommen dort erst an, wenn
+   * alle Regionen berechnet sind. Wandernde Pferde vermehren sich nicht.
    */
 
   for (n = 0; n != MAXDIRECTIONS; n++) {
@@ -657,17 +607,7 @@ static void horses(region * r)
       int pt = (rhorses(r) * HORSEMOVE) / 100;
       pt = (int)normalvariate(pt, pt / 4.0);
       pt = MAX(0, pt);
-      if (fval(r2, RF_MIGRATION))
-        rsethorses(r2, rhorses(r2) + pt);
-      else {
-        migration *nb;
-        /* haben wir die Migration schonmal benutzt?
-         * wenn nicht, mssen wir sie suchen.
-         * Wandernde Pferde vermehren sich nicht.
-         */
-        nb = get_migrants(r2);
-        nb->horses += pt;
-      }
+      migrants[r2->index].horses += pt;
       /* Wandernde Pferde sollten auch abgezogen werden */
       rsethorses(r, rhorses(r) - pt);
     }
@@ -725,7 +665,6 @@ growing_trees_e3(region * r, const int current_season,
             double scale = 1.0;
             int g;
             double fg, ch;
-            int seeds = rtrees(rx, dst_type);
 
             if (r->terrain->size > rx->terrain->size) {
               scale = (scale * rx->terrain->size) / r->terrain->size;
@@ -736,7 +675,7 @@ growing_trees_e3(region * r, const int current_season,
             if (chance(ch))
               ++g;
             if (g > 0) {
-              rsettrees(rx, dst_type, seeds + g);
+              migrants[rx->index].seeds += g;
             }
           }
         }
@@ -818,7 +757,7 @@ growing_trees(region * r, const int current_season, const int last_weeks_season)
           if (rng_int() % 10000 < seedchance)
             sprout++;
         }
-        rsettrees(r2, 0, rtrees(r2, 0) + sprout);
+        migrants[r2->index].seeds += sprout;
       }
     }
 
@@ -901,6 +840,7 @@ void demographics(void)
   region *r;
   static int last_weeks_season = -1;
   static int current_season = -1;
+  unsigned int max_index = 0;
 
   if (current_season < 0) {
     gamedate date;
@@ -915,9 +855,35 @@ void demographics(void)
     live(r);
     /* check_split_dragons(); */
 
-    if (!fval(r->terrain, SEA_REGION)) {
+    if (r->index > max_index) {
+      max_index = r->index;
+    }
+    if (!fval(r->terrain, SEA_REGION) && r->land) {
       /* die Nachfrage nach Produkten steigt. */
       struct demand *dmd;
+      for (dmd = r->land->demands; dmd; dmd = dmd->next) {
+        if (dmd->value > 0 && dmd->value < MAXDEMAND) {
+          float rise = DMRISE;
+          if (buildingtype_exists(r, bt_get(BT_HARBOUR), true))
+            rise = DMRISEHAFEN;
+          if (rng_double() < rise)
+            ++dmd->value;
+        }
+      }
+    }
+  }
+
+  /* Die Wanderung der Bauern richtet sich nach den Zahlen vor dem
+   * Wachstum, fr alle Regionen gleich. */
+  for (r = regions; r; r = r->next) {
+    if (!fval(r->terrain, SEA_REGION) && r->land) {
+      calculate_emigration(r);
+    }
+  }
+
+  migrants = calloc(max_index + 1, sizeof(migration));
+  for (r = regions; r; r = r->next) {
+    if (!fval(r->terrain, SEA_REGION)) {
       if (r->land) {
         static int plant_rules = -1;
 
@@ -925,19 +891,9 @@ void demographics(void)
           plant_rules =
             get_param_int(global.parameters, "rules.economy.grow", 0);
         }
-        for (dmd = r->land->demands; dmd; dmd = dmd->next) {
-          if (dmd->value > 0 && dmd->value < MAXDEMAND) {
-            float rise = DMRISE;
-            if (buildingtype_exists(r, bt_find("harbour"), true))
-              rise = DMRISEHAFEN;
-            if (rng_double() < rise)
-              ++dmd->value;
-          }
-        }
         /* Seuchen erst nachdem die Bauern sich vermehrt haben
          * und gewandert sind */
 
-        calculate_emigration(r);
         if (get_param_int(global.parameters, "rules.peasants.growth", 1)) {
             peasants(r);
         }
@@ -954,15 +910,18 @@ void demographics(void)
       }
 
       update_resources(r);
-      if (r->land)
-        migrate(r);
     }
   }
-  while (free_migrants) {
-    migration *m = free_migrants->next;
-    free(free_migrants);
-    free_migrants = m;
-  };
+
+  /* Pferde und Samen kommen in den Nachbarregionen an */
+  for (r = regions; r; r = r->next) {
+    if (r->land) {
+      migrate(r);
+    }
+  }
+  free(migrants);
+  migrants = NULL;
+
   if (verbosity >= 1)
     putchar('\n');
 
@@ -2253,7 +2212,7 @@ int mail_cmd(unit * u, struct order *ord)
           args[1].data.v = (void *)u;
           args[1].type = "unit";
           args[2].type = NULL;
-          handle_event(a, "message", args);
+          handle_event_id(a, EV_MESSAGE, args);
         }
 
         mailunit(r, u, n, ord, s);
@@ -2738,7 +2697,9 @@ int promotion_cmd(unit * u, struct order *ord)
     return 0;
   }
   use_pooled(u, i_silver->rtype, GET_ALL, people);
+  update_faction_counts(u, -1);
   fset(u, UFL_HERO);
+  update_faction_counts(u, 1);
   ADDMSG(&u->faction->msgs, msg_message("hero_promotion", "unit cost",
       u, people));
   return 0;
@@ -3277,7 +3238,7 @@ static building *age_building(building * b)
   static const curse_type *ct_astralblock;
   if (!init) {
     init = true;
-    bt_blessed = bt_find("blessedstonecircle");
+    bt_blessed = bt_get(BT_BLESSEDSTONECIRCLE);
     ct_astralblock = ct_find("astralblock");
   }
 
@@ -3340,7 +3301,7 @@ static building *age_building(building * b)
   }
 
   a_age(&b->attribs);
-  handle_event(b->attribs, "timer", b);
+  handle_event_id(b->attribs, EV_TIMER, b);
 
   if (b->type->age) {
     b->type->age(b);
@@ -3358,7 +3319,7 @@ static double rc_popularity(const struct race *rc)
 static void age_region(region * r)
 {
   a_age(&r->attribs);
-  handle_event(r->attribs, "timer", r);
+  handle_event_id(r->attribs, EV_TIMER, r);
 
   if (!r->land)
     return;
@@ -3390,33 +3351,41 @@ static void age_region(region * r)
   }
 }
 
+/* altern spezieller Attribute, die eine Sonderbehandlung brauchen */
+static void age_special(unit * u)
+{
+  /* Goliathwasser */
+  int i = get_effect(u, oldpotiontype[P_STRONG]);
+  if (i > 0) {
+    change_effect(u, oldpotiontype[P_STRONG], -1 * MIN(u->number, i));
+  }
+  /* Berserkerblut */
+  i = get_effect(u, oldpotiontype[P_BERSERK]);
+  if (i > 0) {
+    change_effect(u, oldpotiontype[P_BERSERK], -1 * MIN(u->number, i));
+  }
+
+  if (is_cursed(u->attribs, C_OLDRACE, 0)) {
+    curse *c = get_curse(u->attribs, ct_find("oldrace"));
+    if (c->duration == 1 && !(c_flags(c) & CURSE_NOAGE)) {
+      u_setrace(u, new_race[curse_geteffect_int(c)]);
+      u->irace = NULL;
+    }
+  }
+}
+
 static void ageing(void)
 {
   faction *f;
   region *r;
 
-  /* altern spezieller Attribute, die eine Sonderbehandlung brauchen?  */
+  /* Trnke und oldrace zuerst, fr alle Einheiten: age_region() kann
+   * Einheiten in schon abgearbeitete Regionen versetzen. */
   for (r = regions; r; r = r->next) {
     unit *u;
-
     for (u = r->units; u; u = u->next) {
-      /* Goliathwasser */
-      int i = get_effect(u, oldpotiontype[P_STRONG]);
-      if (i > 0) {
-        change_effect(u, oldpotiontype[P_STRONG], -1 * MIN(u->number, i));
-      }
-      /* Berserkerblut */
-      i = get_effect(u, oldpotiontype[P_BERSERK]);
-      if (i > 0) {
-        change_effect(u, oldpotiontype[P_BERSERK], -1 * MIN(u->number, i));
-      }
-
-      if (is_cursed(u->attribs, C_OLDRACE, 0)) {
-        curse *c = get_curse(u->attribs, ct_find("oldrace"));
-        if (c->duration == 1 && !(c_flags(c) & CURSE_NOAGE)) {
-          u_setrace(u, new_race[curse_geteffect_int(c)]);
-          u->irace = NULL;
-        }
+      if (u->attribs) {
+        age_special(u);
       }
     }
   }
@@ -3427,7 +3396,7 @@ static void ageing(void)
   /* Factions */
   for (f = factions; f; f = f->next) {
     a_age(&f->attribs);
-    handle_event(f->attribs, "timer", f);
+    handle_event_id(f->attribs, EV_TIMER, f);
   }
 
   /* Regionen */
@@ -3438,12 +3407,16 @@ static void ageing(void)
 
     age_region(r);
 
-    /* Einheiten */
+    /* Einheiten, ohne Attribute gibt es nichts zu tun */
     for (up = &r->units; *up;) {
       unit *u = *up;
+      if (!u->attribs) {
+        up = &u->next;
+        continue;
+      }
       a_age(&u->attribs);
       if (u == *up)
-        handle_event(u->attribs, "timer", u);
+        handle_event_id(u->attribs, EV_TIMER, u);
       if (u == *up)
         up = &(*up)->next;
     }
@@ -3453,7 +3426,7 @@ static void ageing(void)
       ship *s = *sp;
       a_age(&s->attribs);
       if (s == *sp)
-        handle_event(s->attribs, "timer", s);
+        handle_event_id(s->attribs, EV_TIMER, s);
       if (s == *sp)
         sp = &(*sp)->next;
     }
@@ -3538,70 +3511,70 @@ void new_units(void)
 
       while (*ordp) {
         order *makeord = *ordp;
-        if (get_keyword(makeord) == K_MAKE) {
-          init_tokens(makeord);
-          skip_token();
-          if (isparam(getstrtoken(), u->faction->locale, P_TEMP)) {
-            const char *token;
-            char *name = NULL;
-            int alias;
-            ship *sh;
-            order **newordersp;
-            int err = checkunitnumber(u->faction, 1);
-
-            if (err) {
-              if (err == 1) {
-                ADDMSG(&u->faction->msgs,
-                  msg_feedback(u, makeord,
-                    "too_many_units_in_alliance",
-                    "allowed", maxunits(u->faction)));
-              } else {
-                ADDMSG(&u->faction->msgs,
-                  msg_feedback(u, makeord,
-                    "too_many_units_in_faction",
-                    "allowed", maxunits(u->faction)));
-              }
-              ordp = &makeord->next;
-
-              while (*ordp) {
-                order *ord = *ordp;
-                if (get_keyword(ord) == K_END)
-                  break;
-                *ordp = ord->next;
-                ord->next = NULL;
-                free_order(ord);
-              }
-              continue;
-            }
-            alias = getid();
-
-            token = getstrtoken();
-            if (token && token[0]) {
-              name = _strdup(token);
-            }
-            u2 = create_unit(r, u->faction, 0, u->faction->race, alias, name, u);
-            if (name != NULL)
-              free(name);
-            fset(u2, UFL_ISNEW);
-
-            a_add(&u2->attribs, a_new(&at_alias))->data.i = alias;
-            sh = leftship(u);
-            if (sh) {
-              set_leftship(u2, sh);
+        if (get_keyword(makeord) == K_MAKE
+          && get_order_param(makeord) == P_TEMP) {
+          const char *token;
+          char *name = NULL;
+          int alias;
+          ship *sh;
+          order **newordersp;
+          int err = checkunitnumber(u->faction, 1);
+
+          if (err) {
+            if (err == 1) {
+              ADDMSG(&u->faction->msgs,
+                msg_feedback(u, makeord,
+                  "too_many_units_in_alliance",
+                  "allowed", maxunits(u->faction)));
+            } else {
+              ADDMSG(&u->faction->msgs,
+                msg_feedback(u, makeord,
+                  "too_many_units_in_faction",
+                  "allowed", maxunits(u->faction)));
             }
-            setstatus(u2, u->status);
-
             ordp = &makeord->next;
-            newordersp = &u2->orders;
+
             while (*ordp) {
               order *ord = *ordp;
               if (get_keyword(ord) == K_END)
                 break;
               *ordp = ord->next;
               ord->next = NULL;
-              *newordersp = ord;
-              newordersp = &ord->next;
+              free_order(ord);
             }
+            continue;
+          }
+          init_tokens(makeord);
+          skip_token();       /* MACHE */
+          skip_token();       /* TEMP */
+          alias = getid();
+
+          token = getstrtoken();
+          if (token && token[0]) {
+            name = _strdup(token);
+          }
+          u2 = create_unit(r, u->faction, 0, u->faction->race, alias, name, u);
+          if (name != NULL)
+            free(name);
+          fset(u2, UFL_ISNEW);
+
+          a_add(&u2->attribs, a_new(&at_alias))->data.i = alias;
+          sh = leftship(u);
+          if (sh) {
+            set_leftship(u2, sh);
+          }
+          setstatus(u2, u->status);
+
+          ordp = &makeord->next;
+          newordersp = &u2->orders;
+          while (*ordp) {
+            order *ord = *ordp;
+            if (get_keyword(ord) == K_END)
+              break;
+            *ordp = ord->next;
+            ord->next = NULL;
+            *newordersp = ord;
+            newordersp = &ord->next;
           }
         }
         if (*ordp == makeord)
@@ -3829,7 +3802,7 @@ void monthly_healing(void)
         int addhp;
         struct building *b = inside_building(u);
         const struct building_type *btype = b ? b->type : NULL;
-        if (btype == bt_find("inn")) {
+        if (btype == bt_get(BT_INN)) {
           p *= 1.5;
         }
         /* pro punkt 5% hher */
@@ -4645,6 +4618,7 @@ void processorders(void)
   log_info(" - Attribute altern");
   ageing();
   remove_empty_units();
+  verify_faction_counts();
 
   /* must happen AFTER age, because that would destroy them right away */
   if (get_param_int(global.parameters, "modules.wormholes", 0)) {
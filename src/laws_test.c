@@ -4,6 +4,7 @@
 
 #include <kernel/config.h>
 #include <kernel/building.h>
+#include <kernel/calendar.h>
 #include <kernel/faction.h>
 #include <kernel/item.h>
 #include <kernel/race.h>
@@ -206,6 +207,33 @@ static void test_cannot_create_unit_above_limit(CuTest * tc)
   CuAssertIntEquals(tc, 1, checkunitnumber(f, 4));
 }
 
+static void test_peasant_migration(CuTest * tc)
+{
+  region *r1, *r2;
+  int maxp;
+  int winter[1] = { SEASON_WINTER };
+
+  test_cleanup();
+  test_create_world();
+  months_per_year = weeks_per_month = 1;
+  month_season = winter;
+  set_param(&global.parameters, "rules.peasants.growth", "0");
+  r1 = findregion(0, 0);
+  r2 = findregion(1, 0);
+  maxp = maxworkingpeasants(r1);
+  CuAssertIntEquals(tc, maxp, maxworkingpeasants(r2));
+  /* both regions see the numbers from before anybody moved */
+  rsetpeasants(r1, 0);
+  rsetpeasants(r2, maxp + 600);
+  rsetmoney(r1, 0);
+  rsetmoney(r2, 0);
+  demographics();
+  CuAssertIntEquals(tc, 100, rpeasants(r1));
+  CuAssertIntEquals(tc, maxp + 500, rpeasants(r2));
+  months_per_year = weeks_per_month = 0;
+  month_season = 0;
+}
+
 CuSuite *get_laws_suite(void)
 {
   CuSuite *suite = CuSuiteNew();
@@ -217,5 +245,6 @@ CuSuite *get_laws_suite(void)
   SUITE_ADD_TEST(suite, test_fishing_gets_reset);
   SUITE_ADD_TEST(suite, test_unit_limit);
   SUITE_ADD_TEST(suite, test_cannot_create_unit_above_limit);
+  SUITE_ADD_TEST(suite, test_peasant_migration);
   return suite;
 }
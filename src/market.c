@@ -34,9 +34,7 @@ static unsigned int get_markets(region * r, unit ** results, size_t size)
 {
   unsigned int n = 0;
   building *b;
-  static building_type *btype;
-  if (!btype)
-    btype = bt_find("market");
+  const building_type *btype = bt_get(BT_MARKET);
   if (!btype)
     return 0;
   for (b = r->buildings; n < size && b; b = b->next) {
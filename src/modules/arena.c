@@ -305,7 +305,7 @@ static void tower_init(void)
       if (rterrain(r) != T_DESERT)
         terraform(r, T_DESERT);
       if (!r->buildings) {
-        building *b = new_building(bt_find("castle"), r, NULL);
+        building *b = new_building(bt_get(BT_CASTLE), r, NULL);
         b->size = 10;
         if (i != 0) {
           sprintf(buf, "Turm des %s",
@@ -317,7 +317,7 @@ static void tower_init(void)
     }
   }
   if (first && !arena_center->buildings) {
-    building *b = new_building(bt_find("castle"), arena_center, NULL);
+    building *b = new_building(bt_get(BT_CASTLE), arena_center, NULL);
     attrib *a;
     item *items;
 
@@ -320,13 +320,13 @@ extern int numnewbies;
 static const terrain_type *preferred_terrain(const struct race *rc)
 {
   terrain_t t = T_PLAIN;
-  if (rc == rc_find("dwarf"))
+  if (rc == new_race[RC_DWARF])
     t = T_MOUNTAIN;
-  if (rc == rc_find("insect"))
+  if (rc == new_race[RC_INSECT])
     t = T_DESERT;
-  if (rc == rc_find("halfling"))
+  if (rc == new_race[RC_HALFLING])
     t = T_SWAMP;
-  if (rc == rc_find("troll"))
+  if (rc == new_race[RC_TROLL])
     t = T_MOUNTAIN;
   return newterrain(t);
 }
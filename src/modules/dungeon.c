@@ -175,14 +175,14 @@ void make_dungeongate(region * source, region * target, const struct dungeon *d)
 
   if (source == NULL || target == NULL || d == NULL)
     return;
-  bsource = new_building(bt_find("castle"), source, default_locale);
+  bsource = new_building(bt_get(BT_CASTLE), source, default_locale);
   set_string(&bsource->name, "Pforte zur Hlle");
   bsource->size = 50;
   add_trigger(&bsource->attribs, "timer", trigger_gate(bsource, target));
   add_trigger(&bsource->attribs, "create", trigger_unguard(bsource));
   fset(bsource, BLD_UNGUARDED);
 
-  btarget = new_building(bt_find("castle"), target, default_locale);
+  btarget = new_building(bt_get(BT_CASTLE), target, default_locale);
   set_string(&btarget->name, "Pforte zur Auenwelt");
   btarget->size = 50;
   add_trigger(&btarget->attribs, "timer", trigger_gate(btarget, source));
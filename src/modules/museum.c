@@ -234,7 +234,7 @@ void create_museum(void)
 
   r = findregion(9526, 9525);
   if (!r->buildings) {
-    const building_type *bt_generic = bt_find("generic");
+    const building_type *bt_generic = bt_get(BT_GENERIC);
     b = new_building(bt_generic, r, NULL);
     set_string(&b->name, "Spare im dmonischen Stil");
     set_string(&b->display,
@@ -831,7 +831,7 @@ void plan_monsters(faction * f)
         /* Ab hier noch nicht generalisierte Spezialbehandlungen. */
 
         if (!u->orders) {
-          handle_event(u->attribs, "ai_move", u);
+          handle_event_id(u->attribs, EV_AI_MOVE, u);
         }
 
         switch (old_race(u_race(u))) {
@@ -65,7 +65,7 @@ static void equip_newunits(const struct equipment *eq, struct unit *u)
     break;
   case RC_HUMAN:
     if (u->building == NULL) {
-      const building_type *btype = bt_find("castle");
+      const building_type *btype = bt_get(BT_CASTLE);
       if (btype != NULL) {
         building *b = new_building(btype, r, u->faction->locale);
         b->size = 10;
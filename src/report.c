@@ -1326,7 +1326,7 @@ static void statistics(FILE * F, const region * r, const faction * f)
     msg_release(m);
 
     if (!markets_module()) {
-      if (buildingtype_exists(r, bt_find("caravan"), true)) {
+      if (buildingtype_exists(r, bt_get(BT_CARAVAN), true)) {
         m = msg_message("nr_stat_luxuries", "max", (p * 2) / TRADE_FRACTION);
       } else {
         m = msg_message("nr_stat_luxuries", "max", p / TRADE_FRACTION);
@@ -1471,9 +1471,8 @@ static int
 report_template(const char *filename, report_context * ctx, const char *charset)
 {
   faction *f = ctx->f;
-  region *r;
   FILE *F = fopen(filename, "wt");
-  seen_region *sr = NULL;
+  seen_region *sr, *send = ctx->seen->regions + ctx->seen->size;
   char buf[8192], *bufp;
   size_t size;
   int bytes;
@@ -1510,11 +1509,7 @@ report_template(const char *filename, report_context * ctx, const char *charset)
   rps_nowrap(F, buf);
   rnl(F);
 
-  for (r = ctx->first; sr == NULL && r != ctx->last; r = r->next) {
-    sr = find_seen(ctx->seen, r);
-  }
-
-  for (; sr != NULL; sr = sr->next) {
+  for (sr = ctx->seen->regions; sr != send; ++sr) {
     region *r = sr->r;
     unit *u;
     int dh = 0;
@@ -2018,7 +2013,7 @@ nr_building(FILE * F, const seen_region * sr, const building * b,
     scat(", ");
   }
 
-  if (b->type == bt_find("pyramid")) {
+  if (b->type == bt_get(BT_PYRAMID)) {
     unit *owner = building_owner(b);
     scat("Grenstufe ");
     icat(wdw_pyramid_level(b));
@@ -2098,7 +2093,6 @@ report_plaintext(const char *filename, report_context * ctx,
   int flag = 0;
   char ch;
   int anyunits, no_units, no_people;
-  const struct region *r;
   faction *f = ctx->f;
   unit *u;
   char pzTime[64];
@@ -2108,7 +2102,7 @@ report_plaintext(const char *filename, report_context * ctx,
   int bytes, ix = want(O_STATISTICS);
   int wants_stats = (f->options & ix);
   FILE *F = fopen(filename, "wt");
-  seen_region *sr = NULL;
+  seen_region *sr, *send = ctx->seen->regions + ctx->seen->size;
   char buf[8192];
   char *bufp;
   int enc = xmlParseCharEncoding(charset);
@@ -2360,10 +2354,7 @@ report_plaintext(const char *filename, report_context * ctx,
 
   anyunits = 0;
 
-  for (r = ctx->first; sr == NULL && r != ctx->last; r = r->next) {
-    sr = find_seen(ctx->seen, r);
-  }
-  for (; sr != NULL; sr = sr->next) {
+  for (sr = ctx->seen->regions; sr != send; ++sr) {
     region *r = sr->r;
     int stealthmod = stealth_modifier(sr->mode);
     building *b = r->buildings;
@@ -930,7 +930,7 @@ static int sp_blessstonecircle(castorder * co)
 
   b = p->param[0]->data.b;
 
-  if (b->type != bt_find("stonecircle")) {
+  if (b->type != bt_get(BT_STONECIRCLE)) {
     ADDMSG(&mage->faction->msgs, msg_feedback(mage, co->order,
         "error_notstonecircle", "building", b));
     return 0;
@@ -942,7 +942,7 @@ static int sp_blessstonecircle(castorder * co)
     return 0;
   }
 
-  b->type = bt_find("blessedstonecircle");
+  b->type = bt_get(BT_BLESSEDSTONECIRCLE);
 
   msg = msg_message("blessedstonecircle_effect", "mage building", mage, b);
   add_message(&r->msgs, msg);
@@ -1468,7 +1468,7 @@ static int sp_create_irongolem(castorder * co)
   }
 
   u2 =
-    create_unit(r, mage->faction, number, rc_find("irongolem"), 0, NULL, mage);
+    create_unit(r, mage->faction, number, new_race[RC_IRONGOLEM], 0, NULL, mage);
 
   set_level(u2, SK_ARMORER, 1);
   set_level(u2, SK_WEAPONSMITH, 1);
@@ -1481,7 +1481,7 @@ static int sp_create_irongolem(castorder * co)
   ADDMSG(&mage->faction->msgs,
     msg_message("magiccreate_effect", "region command unit amount object",
       mage->region, co->order, mage, number,
-      LOC(mage->faction->locale, rc_name(rc_find("irongolem"), 1))));
+      LOC(mage->faction->locale, rc_name(new_race[RC_IRONGOLEM], 1))));
 
   return cast_level;
 }
@@ -1530,7 +1530,7 @@ static int sp_create_stonegolem(castorder * co)
   }
 
   u2 =
-    create_unit(r, mage->faction, number, rc_find("stonegolem"), 0, NULL, mage);
+    create_unit(r, mage->faction, number, new_race[RC_STONEGOLEM], 0, NULL, mage);
   set_level(u2, SK_ROAD_BUILDING, 1);
   set_level(u2, SK_BUILDING, 1);
 
@@ -1542,7 +1542,7 @@ static int sp_create_stonegolem(castorder * co)
   ADDMSG(&mage->faction->msgs,
     msg_message("magiccreate_effect", "region command unit amount object",
       mage->region, co->order, mage, number,
-      LOC(mage->faction->locale, rc_name(rc_find("stonegolem"), 1))));
+      LOC(mage->faction->locale, rc_name(new_race[RC_STONEGOLEM], 1))));
 
   return cast_level;
 }
@@ -2003,7 +2003,7 @@ static int sp_homestone(castorder * co)
   float force = co->force;
   float effect;
   message *msg;
-  if (!mage->building || mage->building->type != bt_find("castle")) {
+  if (!mage->building || mage->building->type != bt_get(BT_CASTLE)) {
     cmistake(mage, co->order, 197, MSG_MAGIC);
     return 0;
   }
@@ -3650,7 +3650,7 @@ static int sp_rallypeasantmob(castorder * co)
     }
   }
 
-  c = get_curse(r->attribs, ct_find(oldcursename(C_RIOT)));
+  c = get_curse(r->attribs, oldcursetype(C_RIOT));
   if (c != NULL) {
     remove_curse(&r->attribs, c);
   }
@@ -4400,17 +4400,15 @@ int sp_icastle(castorder * co)
   icastle_data *data;
   const char *bname;
   message *msg;
-  static const building_type *bt_illusion;
+  const building_type *bt_illusion = bt_get(BT_ILLUSIONCASTLE);
 
-  if (bt_illusion == NULL)
-    bt_illusion = bt_find("illusioncastle");
   if (bt_illusion == NULL) {
     return 0;
   }
 
   if ((type =
       findbuildingtype(pa->param[0]->data.xs, mage->faction->locale)) == NULL) {
-    type = bt_find("castle");
+    type = bt_get(BT_CASTLE);
   }
 
   b = new_building(bt_illusion, r, mage->faction->locale);
@@ -5898,8 +5896,8 @@ int sp_movecastle(castorder * co)
     u = unext;
   }
 
-  if ((b->type == bt_find("caravan") || b->type == bt_find("dam")
-      || b->type == bt_find("tunnel"))) {
+  if ((b->type == bt_get(BT_CARAVAN) || b->type == bt_get(BT_DAM)
+      || b->type == bt_get(BT_TUNNEL))) {
     direction_t d;
     for (d = 0; d != MAXDIRECTIONS; ++d) {
       if (rroad(r, d)) {
@@ -221,8 +221,8 @@ teach_unit(unit * teacher, unit * student, int nteaching, skill_t sk,
 
     /* Solange Akademien grenbeschrnkt sind, sollte Lehrer und
      * Student auch in unterschiedlichen Gebuden stehen drfen */
-    if (btype == bt_find("academy")
-      && student->building && student->building->type == bt_find("academy")) {
+    if (btype == bt_get(BT_ACADEMY)
+      && student->building && student->building->type == bt_get(BT_ACADEMY)) {
       int j = study_cost(student, sk);
       j = MAX(50, j * 2);
       /* kann Einheit das zahlen? */
@@ -337,9 +337,7 @@ int teach_cmd(unit * u, struct order *ord)
 #endif
         if (get_keyword(student->thisorder) == K_STUDY) {
           /* Input ist nun von student->thisorder !! */
-          init_tokens(student->thisorder);
-          skip_token();
-          sk = getskill(student->faction->locale);
+          sk = get_order_skill(student->thisorder);
           if (sk != NOSKILL && teachskill[0] != NOSKILL) {
             for (i = 0; teachskill[i] != NOSKILL; ++i)
               if (sk == teachskill[i])
@@ -368,9 +366,7 @@ int teach_cmd(unit * u, struct order *ord)
 #endif
         if (get_keyword(student->thisorder) == K_STUDY) {
           /* Input ist nun von student->thisorder !! */
-          init_tokens(student->thisorder);
-          skip_token();
-          sk = getskill(student->faction->locale);
+          sk = get_order_skill(student->thisorder);
           if (sk != NOSKILL
             && eff_skill_study(u, sk, r) - TEACHDIFFERENCE >= eff_skill(student,
               sk, r)) {
@@ -445,12 +441,7 @@ int teach_cmd(unit * u, struct order *ord)
         continue;
       }
 
-      /* Input ist nun von u2->thisorder !! */
-      parser_pushstate();
-      init_tokens(u2->thisorder);
-      skip_token();
-      sk = getskill(u2->faction->locale);
-      parser_popstate();
+      sk = get_order_skill(u2->thisorder);
 
       if (sk == NOSKILL) {
         ADDMSG(&u->faction->msgs,
@@ -601,7 +592,7 @@ int learn_cmd(unit * u, order * ord)
     struct building *b = inside_building(u);
     const struct building_type *btype = b ? b->type : NULL;
 
-    if (btype && btype == bt_find("academy")) {
+    if (btype && btype == bt_get(BT_ACADEMY)) {
       studycost = MAX(50, studycost * 2);
     }
   }
@@ -740,7 +731,7 @@ int learn_cmd(unit * u, order * ord)
      with an academy */
 
   if (sk == SK_ENTERTAINMENT
-    && buildingtype_exists(r, bt_find("artacademy"), false)) {
+    && buildingtype_exists(r, bt_get(BT_ARTACADEMY), false)) {
     days *= 2;
   }
 
@@ -8,20 +8,33 @@ CuSuite *get_laws_suite(void);
 CuSuite *get_market_suite(void);
 CuSuite *get_battle_suite(void);
 CuSuite *get_building_suite(void);
+CuSuite *get_connection_suite(void);
 CuSuite *get_curse_suite(void);
 CuSuite *get_equipment_suite(void);
 CuSuite *get_item_suite(void);
 CuSuite *get_magic_suite(void);
 CuSuite *get_move_suite(void);
+CuSuite *get_order_suite(void);
+CuSuite *get_save_suite(void);
 CuSuite *get_pool_suite(void);
 CuSuite *get_reports_suite(void);
 CuSuite *get_ship_suite(void);
 CuSuite *get_spellbook_suite(void);
+CuSuite *get_unit_suite(void);
 CuSuite *get_spell_suite(void);
+CuSuite *get_attrib_suite(void);
 CuSuite *get_base36_suite(void);
+CuSuite *get_blockalloc_suite(void);
 CuSuite *get_bsdstring_suite(void);
+CuSuite *get_event_suite(void);
+CuSuite *get_filereader_suite(void);
 CuSuite *get_functions_suite(void);
 CuSuite *get_umlaut_suite(void);
+CuSuite *get_language_suite(void);
+CuSuite *get_unicode_suite(void);
+CuSuite *get_rand_suite(void);
+CuSuite *get_resolve_suite(void);
+CuSuite *get_parser_suite(void);
 CuSuite *get_ally_suite(void);
 
 int RunAllTests(void)
@@ -35,20 +48,33 @@ int RunAllTests(void)
   /* self-test */
   CuSuiteAddSuite(suite, get_tests_suite());
   /* util */
+  CuSuiteAddSuite(suite, get_attrib_suite());
   CuSuiteAddSuite(suite, get_base36_suite());
+  CuSuiteAddSuite(suite, get_blockalloc_suite());
   CuSuiteAddSuite(suite, get_bsdstring_suite());
+  CuSuiteAddSuite(suite, get_event_suite());
+  CuSuiteAddSuite(suite, get_filereader_suite());
   CuSuiteAddSuite(suite, get_functions_suite());
   CuSuiteAddSuite(suite, get_umlaut_suite());
+  CuSuiteAddSuite(suite, get_language_suite());
+  CuSuiteAddSuite(suite, get_unicode_suite());
+  CuSuiteAddSuite(suite, get_rand_suite());
+  CuSuiteAddSuite(suite, get_resolve_suite());
+  CuSuiteAddSuite(suite, get_parser_suite());
   /* kernel */
   CuSuiteAddSuite(suite, get_pool_suite());
+  CuSuiteAddSuite(suite, get_connection_suite());
   CuSuiteAddSuite(suite, get_curse_suite());
   CuSuiteAddSuite(suite, get_equipment_suite());
   CuSuiteAddSuite(suite, get_item_suite());
   CuSuiteAddSuite(suite, get_magic_suite());
   CuSuiteAddSuite(suite, get_move_suite());
+  CuSuiteAddSuite(suite, get_order_suite());
+  CuSuiteAddSuite(suite, get_save_suite());
   CuSuiteAddSuite(suite, get_reports_suite());
   CuSuiteAddSuite(suite, get_ship_suite());
   CuSuiteAddSuite(suite, get_spellbook_suite());
+  CuSuiteAddSuite(suite, get_unit_suite());
   CuSuiteAddSuite(suite, get_building_suite());
   CuSuiteAddSuite(suite, get_spell_suite());
   CuSuiteAddSuite(suite, get_battle_suite());
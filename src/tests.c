@@ -1,6 +1,7 @@
 #include <platform.h>
 #include <kernel/types.h>
 #include "tests.h"
+#include "economy.h"
 
 #include <kernel/config.h>
 #include <kernel/region.h>
@@ -13,7 +14,10 @@
 #include <kernel/ship.h>
 #include <kernel/spell.h>
 #include <kernel/spellbook.h>
+#include <kernel/skill.h>
 #include <kernel/terrain.h>
+#include <kernel/magic.h>
+#include <kernel/save.h>
 #include <util/functions.h>
 #include <util/language.h>
 #include <util/log.h>
@@ -62,6 +66,7 @@ void test_cleanup(void)
   free_locales();
   free_spells();
   free_spellbooks();
+  free_allocations();
   free_gamedata();
 }
 
@@ -80,7 +85,7 @@ test_create_terrain(const char * name, unsigned int flags)
 
 building * test_create_building(region * r, const building_type * btype)
 {
-  building * b = new_building(btype?btype:bt_find("castle"), r, default_locale);
+  building * b = new_building(btype?btype:bt_get(BT_CASTLE), r, default_locale);
   b->size = b->type->maxsize>0?b->type->maxsize:1;
   return b;
 }
@@ -122,6 +127,54 @@ item_type * test_create_itemtype(const char ** names) {
   return itype;
 }
 
+/** creates the 'de' locale with every keyword, parameter, option, skill,
+ * direction, magic school and race translated to its own key, and builds
+ * the parser tables for it. Call this before creating terrains.
+ */
+struct locale * test_create_locale(void)
+{
+  return test_create_named_locale("de");
+}
+
+struct locale * test_create_named_locale(const char *name)
+{
+  const char *dirs[] = {
+    "dir_ne", "dir_nw", "dir_se", "dir_sw", "dir_east", "dir_west",
+    "northeast", "northwest", "southeast", "southwest", "east", "west",
+    "PAUSE", NULL
+  };
+  struct locale *lang = make_locale(name);
+  const struct race *rc;
+  int i;
+
+  for (i = 0; i != MAXKEYWORDS; ++i) {
+    if (keywords[i])
+      locale_setstring(lang, keywords[i], keywords[i]);
+  }
+  for (i = 0; i != MAXPARAMS; ++i) {
+    locale_setstring(lang, parameters[i], parameters[i]);
+  }
+  for (i = 0; i != MAXOPTIONS; ++i) {
+    if (options[i])
+      locale_setstring(lang, options[i], options[i]);
+  }
+  for (i = 0; i != MAXSKILLS; ++i) {
+    locale_setstring(lang, mkname("skill", skillnames[i]), skillnames[i]);
+  }
+  for (i = 0; dirs[i]; ++i) {
+    locale_setstring(lang, dirs[i], dirs[i]);
+  }
+  for (i = 0; i != MAXMAGIETYP; ++i) {
+    locale_setstring(lang, mkname("school", magic_school[i]), magic_school[i]);
+  }
+  for (rc = races; rc; rc = rc->next) {
+    locale_setstring(lang, rc_name(rc, 0), rc->_name[0]);
+    locale_setstring(lang, rc_name(rc, 1), rc->_name[0]);
+  }
+  init_locales();
+  return lang;
+}
+
 /** creates a small world and some stuff in it.
  * two terrains: 'plain' and 'ocean'
  * one race: 'human'
@@ -14,6 +14,8 @@ extern "C" {
   struct faction *test_create_faction(const struct race *rc);
   struct unit *test_create_unit(struct faction *f, struct region *r);
   void test_create_world(void);
+  struct locale * test_create_locale(void);
+  struct locale * test_create_named_locale(const char *name);
   struct building * test_create_building(struct region * r, const struct building_type * btype);
   struct ship * test_create_ship(struct region * r, const struct ship_type * stype);
   struct item_type * test_create_itemtype(const char ** names);
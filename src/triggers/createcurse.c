@@ -110,7 +110,7 @@ static int createcurse_read(trigger * t, struct storage *store)
     READ_INT(store, &n);
     td->effect = (float)n;
     READ_INT(store, &td->men);
-    td->type = ct_find(oldcursename(id1));
+    td->type = oldcursetype(id1);
   } else {
     READ_TOK(store, zText, sizeof(zText));
     td->type = ct_find(zText);
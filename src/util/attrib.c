@@ -19,6 +19,7 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include <platform.h>
 #include "attrib.h"
 
+#include "blockalloc.h"
 #include "log.h"
 #include "storage.h"
 
@@ -149,12 +150,20 @@ attrib *a_add(attrib ** pa, attrib * a)
   return a;
 }
 
+/* attributes are allocated in blocks and reused when freed */
+static block_allocator acache = BLOCK_ALLOCATOR(attrib, 1024);
+
 void a_free(attrib * a)
 {
   const attrib_type *at = a->type;
   if (at->finalize)
     at->finalize(a);
-  free(a);
+  ba_free(&acache, a);
+}
+
+void a_freeblocks(void)
+{
+  ba_release(&acache);
 }
 
 static int a_unlink(attrib ** pa, attrib * a)
@@ -235,7 +244,8 @@ void a_removeall(attrib ** pa, const attrib_type * at)
 
 attrib *a_new(const attrib_type * at)
 {
-  attrib *a = (attrib *) calloc(1, sizeof(attrib));
+  attrib *a = (attrib *)ba_alloc(&acache);
+  memset(a, 0, sizeof(attrib));
   assert(at != NULL);
   a->type = at;
   if (at->initialize)
@@ -257,8 +267,15 @@ int a_age(attrib ** p)
         a_remove(p, a);
         continue;
       }
+      ap = &a->next;
+    } else {
+      /* types without age() are skipped as a whole, they are stored
+       * next to each other */
+      const attrib_type *at = a->type;
+      do {
+        ap = &(*ap)->next;
+      } while (*ap && (*ap)->type == at);
     }
-    ap = &a->next;
   }
   return (*p != NULL);
 }
@@ -73,6 +73,7 @@ extern "C" {
   extern void a_removeall(attrib ** a, const attrib_type * at);
   extern attrib *a_new(const attrib_type * at);
   extern void a_free(attrib * a);
+  extern void a_freeblocks(void);
 
   extern int a_age(attrib ** attribs);
   extern int a_read(struct storage *store, attrib ** attribs, void *owner);
@@ -0,0 +1,66 @@
+#include <platform.h>
+#include "attrib.h"
+
+#include <CuTest.h>
+
+static int age_countdown(attrib * a)
+{
+  return --a->data.i;
+}
+
+static attrib_type at_countdown = {
+  "countdown", NULL, NULL, age_countdown, NULL, NULL
+};
+
+static attrib_type at_static = {
+  "static", NULL, NULL, NULL, NULL, NULL
+};
+
+static attrib_type at_other = {
+  "other", NULL, NULL, NULL, NULL, NULL
+};
+
+static int count_attribs(const attrib * a)
+{
+  int n = 0;
+  for (; a; a = a->next) {
+    ++n;
+  }
+  return n;
+}
+
+static void test_age(CuTest * tc)
+{
+  attrib *attribs = NULL;
+  attrib *a;
+  int i;
+
+  a_add(&attribs, a_new(&at_static));
+  a_add(&attribs, a_new(&at_static));
+  for (i = 1; i <= 3; ++i) {
+    a = a_add(&attribs, a_new(&at_countdown));
+    a->data.i = i;
+  }
+  a_add(&attribs, a_new(&at_other));
+  CuAssertIntEquals(tc, 6, count_attribs(attribs));
+
+  /* only the countdown attributes age, one of them runs out each turn */
+  CuAssertTrue(tc, a_age(&attribs));
+  CuAssertIntEquals(tc, 5, count_attribs(attribs));
+  CuAssertTrue(tc, a_age(&attribs));
+  CuAssertTrue(tc, a_age(&attribs));
+  CuAssertIntEquals(tc, 3, count_attribs(attribs));
+  CuAssertPtrEquals(tc, 0, a_find(attribs, &at_countdown));
+  CuAssertPtrNotNull(tc, a_find(attribs, &at_other));
+
+  a_removeall(&attribs, &at_static);
+  a_removeall(&attribs, &at_other);
+  CuAssertTrue(tc, !a_age(&attribs));
+}
+
+CuSuite *get_attrib_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_age);
+  return suite;
+}
@@ -0,0 +1,103 @@
+#include <platform.h>
+#include "blockalloc.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+/* the free list is kept in the first bytes of the free objects */
+#define NEXT(obj) (*(void **)(obj))
+
+/** index of the block that contains obj */
+static int ba_find(const block_allocator * ba, const char *obj)
+{
+  int lo = 0, hi = ba->nblocks - 1;
+  while (lo < hi) {
+    int mid = (lo + hi + 1) / 2;
+    if (ba->blocks[mid] <= obj) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  assert(obj >= ba->blocks[lo] && obj < ba->blocks[lo] + ba->count * ba->size);
+  return lo;
+}
+
+static void ba_grow(block_allocator * ba)
+{
+  char *block;
+  int i, n;
+
+  assert(ba->size >= sizeof(void *) && ba->count > 0);
+  block = (char *)malloc(ba->count * ba->size);
+  if (ba->nblocks == ba->maxblocks) {
+    ba->maxblocks = ba->maxblocks ? ba->maxblocks * 2 : 16;
+    ba->blocks = (char **)realloc(ba->blocks, ba->maxblocks * sizeof(char *));
+  }
+  for (i = ba->nblocks; i > 0 && ba->blocks[i - 1] > block; --i) {
+    ba->blocks[i] = ba->blocks[i - 1];
+  }
+  ba->blocks[i] = block;
+  ++ba->nblocks;
+  /* hand the objects out in address order */
+  for (n = ba->count - 1; n >= 0; --n) {
+    char *obj = block + n * ba->size;
+    NEXT(obj) = ba->freelist;
+    ba->freelist = obj;
+  }
+}
+
+void *ba_alloc(block_allocator * ba)
+{
+  void *obj;
+  if (ba->freelist == NULL) {
+    ba_grow(ba);
+  }
+  obj = ba->freelist;
+  ba->freelist = NEXT(obj);
+  return obj;
+}
+
+void ba_free(block_allocator * ba, void *obj)
+{
+  NEXT(obj) = ba->freelist;
+  ba->freelist = obj;
+}
+
+void ba_release(block_allocator * ba)
+{
+  int *nfree;
+  void *obj, *next;
+  int i, n = 0;
+
+  if (ba->nblocks == 0) {
+    return;
+  }
+  nfree = (int *)calloc(ba->nblocks, sizeof(int));
+  for (obj = ba->freelist; obj; obj = NEXT(obj)) {
+    ++nfree[ba_find(ba, (const char *)obj)];
+  }
+  /* keep only the free objects of blocks that are still in use */
+  obj = ba->freelist;
+  ba->freelist = NULL;
+  for (; obj; obj = next) {
+    next = NEXT(obj);
+    if (nfree[ba_find(ba, (const char *)obj)] != ba->count) {
+      ba_free(ba, obj);
+    }
+  }
+  for (i = 0; i != ba->nblocks; ++i) {
+    if (nfree[i] == ba->count) {
+      free(ba->blocks[i]);
+    } else {
+      ba->blocks[n++] = ba->blocks[i];
+    }
+  }
+  free(nfree);
+  ba->nblocks = n;
+  if (n == 0) {
+    free(ba->blocks);
+    ba->blocks = NULL;
+    ba->maxblocks = 0;
+  }
+}
@@ -0,0 +1,30 @@
+#ifndef UTIL_BLOCKALLOC_H
+#define UTIL_BLOCKALLOC_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /* hands out objects of one size from blocks of count objects. freed
+   * objects go on a free list and are reused; ba_release() returns the
+   * blocks in which no object is in use. */
+  typedef struct block_allocator {
+    size_t size;
+    int count;
+    void *freelist;
+    char **blocks;              /* sorted by address */
+    int nblocks, maxblocks;
+  } block_allocator;
+
+#define BLOCK_ALLOCATOR(type, count) { sizeof(type), count, NULL, NULL, 0, 0 }
+
+  void *ba_alloc(block_allocator * ba);
+  void ba_free(block_allocator * ba, void *obj);
+  void ba_release(block_allocator * ba);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,65 @@
+#include <platform.h>
+#include "blockalloc.h"
+
+#include <CuTest.h>
+
+typedef struct thing {
+  struct thing *next;
+  int value;
+} thing;
+
+static void test_alloc_reuses(CuTest * tc)
+{
+  block_allocator ba = BLOCK_ALLOCATOR(thing, 4);
+  thing *a, *b;
+
+  a = (thing *)ba_alloc(&ba);
+  b = (thing *)ba_alloc(&ba);
+  CuAssertPtrEquals(tc, a + 1, b);
+  CuAssertIntEquals(tc, 1, ba.nblocks);
+  ba_free(&ba, a);
+  CuAssertPtrEquals(tc, a, ba_alloc(&ba));
+  ba_free(&ba, a);
+  ba_free(&ba, b);
+  ba_release(&ba);
+  CuAssertIntEquals(tc, 0, ba.nblocks);
+  CuAssertPtrEquals(tc, 0, ba.freelist);
+}
+
+static void test_release_keeps_used_blocks(CuTest * tc)
+{
+  block_allocator ba = BLOCK_ALLOCATOR(thing, 4);
+  thing *things[12];
+  int i, nfree = 0;
+  void *obj;
+
+  for (i = 0; i != 12; ++i) {
+    things[i] = (thing *)ba_alloc(&ba);
+    things[i]->value = i;
+  }
+  CuAssertIntEquals(tc, 3, ba.nblocks);
+  for (i = 0; i != 12; ++i) {
+    if (i != 5) {
+      ba_free(&ba, things[i]);
+    }
+  }
+  /* only the block that holds things[5] is still in use */
+  ba_release(&ba);
+  CuAssertIntEquals(tc, 1, ba.nblocks);
+  CuAssertIntEquals(tc, 5, things[5]->value);
+  for (obj = ba.freelist; obj; obj = *(void **)obj) {
+    ++nfree;
+  }
+  CuAssertIntEquals(tc, 3, nfree);
+  ba_free(&ba, things[5]);
+  ba_release(&ba);
+  CuAssertIntEquals(tc, 0, ba.nblocks);
+}
+
+CuSuite *get_blockalloc_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_alloc_reuses);
+  SUITE_ADD_TEST(suite, test_release_keeps_used_blocks);
+  return suite;
+}
@@ -111,12 +111,73 @@ int handle_triggers(trigger ** triggers, void *param)
   return (*triggers != NULL);
 }
 
+/***
+ ** event names
+ **/
+
+/* every event name is stored once, handlers refer to it by number. The
+ * first MAXEVENTS are the names of event_t and never change. */
+static const char *defaultevents[MAXEVENTS] = {
+  "timer", "destroy", "give", "receive", "message", "ai_move"
+};
+
+static const char **eventnames;
+static int numevents, maxevents;
+
+static void init_events(void)
+{
+  maxevents = 16;
+  eventnames = (const char **)malloc(maxevents * sizeof(char *));
+  memcpy(eventnames, defaultevents, sizeof(defaultevents));
+  numevents = MAXEVENTS;
+}
+
+void free_events(void)
+{
+  int i;
+  for (i = MAXEVENTS; i < numevents; ++i) {
+    free((char *)eventnames[i]);
+  }
+  free(eventnames);
+  eventnames = NULL;
+  numevents = maxevents = 0;
+}
+
+static int find_event(const char *eventname)
+{
+  int i;
+  if (!eventnames) {
+    init_events();
+  }
+  for (i = 0; i != numevents; ++i) {
+    if (strcmp(eventnames[i], eventname) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+static int event_id(const char *eventname)
+{
+  int i = find_event(eventname);
+  if (i < 0) {
+    if (numevents == maxevents) {
+      maxevents *= 2;
+      eventnames = (const char **)realloc(eventnames,
+        maxevents * sizeof(char *));
+    }
+    eventnames[numevents] = _strdup(eventname);
+    i = numevents++;
+  }
+  return i;
+}
+
 /***
  ** at_eventhandler
  **/
 
 typedef struct handler_info {
-  char *event;
+  int event;
   trigger *triggers;
 } handler_info;
 
@@ -129,7 +190,6 @@ static void free_handler(attrib * a)
 {
   handler_info *hi = (handler_info *) a->data.v;
   free_triggers(hi->triggers);
-  free(hi->event);
   free(hi);
 }
 
@@ -137,7 +197,7 @@ static void
 write_handler(const attrib * a, const void *owner, struct storage *store)
 {
   handler_info *hi = (handler_info *) a->data.v;
-  WRITE_TOK(store, hi->event);
+  WRITE_TOK(store, eventnames[hi->event]);
   write_triggers(store, hi->triggers);
 }
 
@@ -147,7 +207,7 @@ static int read_handler(attrib * a, void *owner, struct storage *store)
   handler_info *hi = (handler_info *) a->data.v;
 
   READ_TOK(store, zText, sizeof(zText));
-  hi->event = _strdup(zText);
+  hi->event = event_id(zText);
   read_triggers(store, &hi->triggers);
   if (hi->triggers != NULL) {
     return AT_READ_OK;
@@ -164,16 +224,26 @@ attrib_type at_eventhandler = {
   read_handler
 };
 
+static handler_info *find_handler(attrib * a, int event)
+{
+  while (a != NULL && a->type == &at_eventhandler) {
+    handler_info *td = (handler_info *) a->data.v;
+    if (td->event == event) {
+      return td;
+    }
+    a = a->next;
+  }
+  return NULL;
+}
+
 struct trigger **get_triggers(struct attrib *ap, const char *eventname)
 {
-  handler_info *td = NULL;
   attrib *a = a_find(ap, &at_eventhandler);
-  while (a != NULL && a->type == &at_eventhandler) {
-    td = (handler_info *) a->data.v;
-    if (strcmp(td->event, eventname) == 0) {
+  if (a != NULL) {
+    handler_info *td = find_handler(a, find_event(eventname));
+    if (td) {
       return &td->triggers;
     }
-    a = a->next;
   }
   return NULL;
 }
@@ -181,20 +251,13 @@ struct trigger **get_triggers(struct attrib *ap, const char *eventname)
 void add_trigger(struct attrib **ap, const char *eventname, struct trigger *t)
 {
   trigger **tp;
-  handler_info *td = NULL;
-  attrib *a = a_find(*ap, &at_eventhandler);
+  int event = event_id(eventname);
+  handler_info *td = find_handler(a_find(*ap, &at_eventhandler), event);
   assert(t->next == NULL);
-  while (a != NULL && a->type == &at_eventhandler) {
-    td = (handler_info *) a->data.v;
-    if (!strcmp(td->event, eventname)) {
-      break;
-    }
-    a = a->next;
-  }
-  if (a == NULL || a->type != &at_eventhandler) {
-    a = a_add(ap, a_new(&at_eventhandler));
+  if (td == NULL) {
+    attrib *a = a_add(ap, a_new(&at_eventhandler));
     td = (handler_info *) a->data.v;
-    td->event = _strdup(eventname);
+    td->event = event;
   }
   tp = &td->triggers;
   while (*tp)
@@ -202,21 +265,36 @@ void add_trigger(struct attrib **ap, const char *eventname, struct trigger *t)
   *tp = t;
 }
 
-void handle_event(attrib * attribs, const char *eventname, void *data)
+static attrib *find_handlers(attrib * attribs)
 {
   while (attribs) {
     if (attribs->type == &at_eventhandler)
       break;
     attribs = attribs->nexttype;
   }
-  while (attribs && attribs->type == &at_eventhandler) {
-    handler_info *tl = (handler_info *) attribs->data.v;
-    if (!strcmp(tl->event, eventname)) {
-      handler_info *tl = (handler_info *) attribs->data.v;
+  return attribs;
+}
+
+void handle_event(attrib * attribs, const char *eventname, void *data)
+{
+  attribs = find_handlers(attribs);
+  if (attribs) {
+    /* most objects have no handlers, only look up the name for the others */
+    handler_info *tl = find_handler(attribs, find_event(eventname));
+    if (tl) {
+      handle_triggers(&tl->triggers, data);
+    }
+  }
+}
+
+void handle_event_id(attrib * attribs, event_t event, void *data)
+{
+  attribs = find_handlers(attribs);
+  if (attribs) {
+    handler_info *tl = find_handler(attribs, (int)event);
+    if (tl) {
       handle_triggers(&tl->triggers, data);
-      break;
     }
-    attribs = attribs->next;
   }
 }
 
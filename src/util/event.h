@@ -70,6 +70,21 @@ extern "C" {
   extern void handle_event(struct attrib *attribs, const char *eventname,
     void *data);
 
+/* events raised by the server itself have fixed numbers, so the callers
+ * can skip looking up the name */
+  typedef enum {
+    EV_TIMER,
+    EV_DESTROY,
+    EV_GIVE,
+    EV_RECEIVE,
+    EV_MESSAGE,
+    EV_AI_MOVE,
+    MAXEVENTS
+  } event_t;
+  extern void handle_event_id(struct attrib *attribs, event_t event,
+    void *data);
+  extern void free_events(void);
+
 /* functions for making complex triggers: */
   extern void free_triggers(trigger * triggers);        /* release all these triggers */
   extern void write_triggers(struct storage *store, const trigger * t);
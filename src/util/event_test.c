@@ -0,0 +1,104 @@
+#include <platform.h>
+#include "event.h"
+#include "attrib.h"
+
+#include <CuTest.h>
+#include <stdlib.h>
+
+static int count_handle(trigger * t, void *data)
+{
+  int *calls = (int *)data;
+  ++calls[t->data.i];
+  return 0;
+}
+
+static trigger_type tt_count = {
+  "count",
+  NULL,
+  NULL,
+  count_handle,
+  NULL,
+  NULL
+};
+
+static trigger *trigger_count(int i)
+{
+  trigger *t = t_new(&tt_count);
+  t->data.i = i;
+  return t;
+}
+
+static void test_handle_event(CuTest * tc)
+{
+  attrib *attribs = NULL;
+  int calls[3] = { 0, 0, 0 };
+  trigger **tp;
+
+  add_trigger(&attribs, "timer", trigger_count(0));
+  add_trigger(&attribs, "destroy", trigger_count(1));
+  add_trigger(&attribs, "timer", trigger_count(2));
+
+  handle_event(attribs, "timer", calls);
+  CuAssertIntEquals(tc, 1, calls[0]);
+  CuAssertIntEquals(tc, 0, calls[1]);
+  CuAssertIntEquals(tc, 1, calls[2]);
+
+  /* names are compared by value, not by address */
+  {
+    char name[] = "destroy";
+    handle_event(attribs, name, calls);
+  }
+  CuAssertIntEquals(tc, 1, calls[1]);
+  handle_event(attribs, "no such event", calls);
+  CuAssertIntEquals(tc, 1, calls[0]);
+  CuAssertIntEquals(tc, 1, calls[1]);
+  CuAssertIntEquals(tc, 1, calls[2]);
+
+  tp = get_triggers(attribs, "timer");
+  CuAssertPtrNotNull(tc, tp);
+  CuAssertIntEquals(tc, 0, (*tp)->data.i);
+  CuAssertIntEquals(tc, 2, (*tp)->next->data.i);
+  CuAssertPtrEquals(tc, 0, get_triggers(attribs, "no such event"));
+
+  remove_triggers(&attribs, "timer", &tt_count);
+  handle_event(attribs, "timer", calls);
+  CuAssertIntEquals(tc, 1, calls[0]);
+  a_removeall(&attribs, &at_eventhandler);
+}
+
+static void test_handle_event_id(CuTest * tc)
+{
+  attrib *attribs = NULL;
+  int calls[3] = { 0, 0, 0 };
+
+  add_trigger(&attribs, "timer", trigger_count(0));
+  add_trigger(&attribs, "custom", trigger_count(1));
+  add_trigger(&attribs, "destroy", trigger_count(2));
+  handle_event_id(attribs, EV_TIMER, calls);
+  CuAssertIntEquals(tc, 1, calls[0]);
+  CuAssertIntEquals(tc, 0, calls[1]);
+  CuAssertIntEquals(tc, 0, calls[2]);
+  handle_event_id(attribs, EV_DESTROY, calls);
+  CuAssertIntEquals(tc, 1, calls[2]);
+  handle_event(attribs, "custom", calls);
+  CuAssertIntEquals(tc, 1, calls[1]);
+  a_removeall(&attribs, &at_eventhandler);
+
+  /* the fixed ids survive freeing the names */
+  free_events();
+  add_trigger(&attribs, "custom", trigger_count(1));
+  add_trigger(&attribs, "timer", trigger_count(0));
+  handle_event_id(attribs, EV_TIMER, calls);
+  CuAssertIntEquals(tc, 2, calls[0]);
+  CuAssertIntEquals(tc, 1, calls[1]);
+  a_removeall(&attribs, &at_eventhandler);
+  free_events();
+}
+
+CuSuite *get_event_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_handle_event);
+  SUITE_ADD_TEST(suite, test_handle_event_id);
+  return suite;
+}
@@ -7,224 +7,100 @@
 #include <libxml/encoding.h>
 
 #include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 #include <wctype.h>
 
 #define COMMENT_CHAR    ';'
 #define CONTINUE_CHAR    '\\'
 #define MAXLINE 4096*16
 static char lbuf[MAXLINE];
-static char fbuf[MAXLINE];
+static char fbuf[MAXLINE * 2];
+
+#define IS_EOL(c) ((c) == '\n' || (c) == '\r' || (c) == '\0')
+
+struct filereader {
+  char *data;
+  char *pos;
+  char *end;
+};
 
 static void unicode_warning(const char *bp)
 {
   log_warning("invalid sequence in UTF-8 string: %s\n", bp);
 }
 
-INLINE_FUNCTION int eatwhite(const char *ptr, size_t * total_size)
+/* characters that can be copied without looking at them twice */
+INLINE_FUNCTION bool is_plain(char ch)
 {
-  int ret = 0;
-
-  *total_size = 0;
-
-  while (*ptr) {
-    ucs4_t ucs;
-    size_t size = 0;
-    ret = unicode_utf8_to_ucs4(&ucs, ptr, &size);
-    if (ret != 0)
-      break;
-    if (!iswxspace((wint_t) ucs))
-      break;
-    *total_size += size;
-    ptr += size;
-  }
-  return ret;
+  unsigned char c = (unsigned char)ch;
+  return c > ' ' && c < 0x7F && c != COMMENT_CHAR && c != CONTINUE_CHAR
+    && c != '"' && c != '\'';
 }
 
-static const char *getbuf_latin1(FILE * F)
+/* skip white space, but never past the end of the line */
+static char *eatwhite(char *bp, int *err)
 {
-  bool cont = false;
-  char quote = 0;
-  bool comment = false;
-  char *cp = fbuf;
-  char *tail = lbuf + MAXLINE - 2;
-
-  tail[1] = '@';                /* if this gets overwritten by fgets then the line was very long. */
-  do {
-    const char *bp = fgets(lbuf, MAXLINE, F);
-
-    if (bp == NULL)
-      return NULL;
-    while (*bp && isxspace(*(unsigned char *)bp))
-      ++bp;                     /* eatwhite */
-
-    comment = (bool) (comment && cont);
-    quote = (bool) (quote && cont);
+  for (;;) {
+    ucs4_t ucs;
+    size_t size;
+    unsigned char c = (unsigned char)*bp;
 
-    if (tail[1] == 0) {
-      /* we read he maximum number of bytes! */
-      if (tail[0] != '\n') {
-        /* it wasn't enough space to finish the line, eat the rest */
-        for (;;) {
-          tail[1] = '@';
-          bp = fgets(lbuf, MAXLINE, F);
-          if (bp == NULL)
-            return NULL;
-          if (tail[1]) {
-            /* read enough this time to end the line */
-            break;
-          }
-        }
-        comment = false;
-        cont = false;
-        bp = NULL;
-        continue;
-      } else {
-        tail[1] = '@';
-      }
+    if (c == ' ' || c == '\t' || c == '\v' || c == '\f') {
+      ++bp;
+      continue;
     }
-    cont = false;
-    while (*bp && cp < fbuf + MAXLINE) {
-      int c = *(unsigned char *)bp;
-
-      if (c == '\n' || c == '\r') {
-        /* line breaks, shmine breaks */
-        break;
-      }
-      if (c == COMMENT_CHAR && !quote) {
-        /* comment begins. we need to keep going, to look for CONTINUE_CHAR */
-        comment = true;
-        ++bp;
-        continue;
-      }
-      if (!comment && (c == '"' || c == '\'')) {
-        if (quote == c) {
-          quote = 0;
-          if (cp < fbuf + MAXLINE)
-            *cp++ = *bp;
-          ++bp;
-          continue;
-        } else if (!quote) {
-          quote = *bp++;
-          if (cp < fbuf + MAXLINE)
-            *cp++ = quote;
-          continue;
-        }
-      }
-
-      if (iscntrl(c)) {
-        if (!comment && cp < fbuf + MAXLINE) {
-          *cp++ = isxspace(c) ? ' ' : '?';
-        }
-        ++bp;
-        continue;
-      } else if (isxspace(c)) {
-        if (!quote) {
-          ++bp;
-          while (*bp && isxspace(*(unsigned char *)bp))
-            ++bp;               /* eatwhite */
-          if (!comment && *bp && *bp != COMMENT_CHAR && cp < fbuf + MAXLINE)
-            *(cp++) = ' ';
-        } else if (!comment && cp + 1 <= fbuf + MAXLINE) {
-          *(cp++) = *(bp++);
-        } else {
-          ++bp;
-        }
-        continue;
-      } else if (c == CONTINUE_CHAR) {
-        const char *end = ++bp;
-        while (*end && isxspace(*(unsigned char *)end))
-          ++end;                /* eatwhite */
-        if (*end == '\0') {
-          bp = end;
-          cont = true;
-          continue;
-        }
-        if (comment) {
-          ++bp;
-          continue;
-        }
-      } else if (comment) {
-        ++bp;
-        continue;
-      }
-
-      if (c < 0x80) {
-        if (cp + 1 <= fbuf + MAXLINE) {
-          *(cp++) = *(bp++);
-        }
-      } else {
-        char inbuf = (char)c;
-        size_t inbytes = 1;
-        size_t outbytes = MAXLINE - (cp - fbuf);
-        int ret = unicode_latin1_to_utf8(cp, &outbytes, &inbuf, &inbytes);
-        if (ret > 0)
-          cp += ret;
-        else {
-          log_error("input data was not iso-8859-1! assuming utf-8\n");
-          return NULL;
-        }
-
-        ++bp;
-        continue;
-      }
+    if (c < 0x80) {
+      return bp;
     }
-    if (cp == fbuf + MAXLINE) {
-      --cp;
+    *err = unicode_utf8_to_ucs4(&ucs, bp, &size);
+    if (*err != 0 || !iswxspace((wint_t) ucs)) {
+      return bp;
     }
-    *cp = 0;
-  } while (cont || cp == fbuf);
-  return fbuf;
+    bp += size;
+  }
 }
 
-static const char *getbuf_utf8(FILE * F)
+/* Cleans up one logical line of UTF-8 text in place: removes comments,
+ * folds white space and joins continued lines. The result is never longer
+ * than the input, so it is written over the input. Returns the start of
+ * the line, *nextp is set to the first physical line after it. */
+static char *clean_line(char *bp, const char *end, char **nextp)
 {
-  bool cont = false;
+  char *begin, *cp;
   char quote = 0;
-  bool comment = false;
-  char *cp = fbuf;
-  char *tail = lbuf + MAXLINE - 2;
+  bool comment = false, cont;
+  int err = 0;
 
-  tail[1] = '@';                /* if this gets overwritten by fgets then the line was very long. */
+  begin = cp = bp = eatwhite(bp, &err);
   do {
-    const char *bp = fgets(lbuf, MAXLINE, F);
-    size_t white;
-    if (bp == NULL) {
-      return NULL;
-    }
-
-    eatwhite(bp, &white);       /* decoding errors will get caught later on, don't have to check */
-    bp += white;
-
-    comment = (bool) (comment && cont);
-    quote = (bool) (quote && cont);
+    const char *eol;
+    cont = false;
+    while (!IS_EOL(*bp)) {
+      ucs4_t ucs;
+      size_t size;
+      int ret;
 
-    if (tail[1] == 0) {
-      /* we read the maximum number of bytes! */
-      if (tail[0] != '\n') {
-        /* it wasn't enough space to finish the line, eat the rest */
+      if (!comment) {
+        /* most of the text needs no special treatment at all */
+        char *run = bp;
         for (;;) {
-          tail[1] = '@';
-          bp = fgets(lbuf, MAXLINE, F);
-          if (bp == NULL)
-            return NULL;
-          if (tail[1]) {
-            /* read enough this time to end the line */
+          if (is_plain(*bp)) {
+            ++bp;
+          } else if (*bp == ' ' && is_plain(bp[1])) {
+            bp += 2;
+          } else {
             break;
           }
         }
-        comment = false;
-        cont = false;
-        bp = NULL;
-        continue;
-      } else {
-        tail[1] = '@';
+        if (bp != run) {
+          if (cp != run) {
+            memmove(cp, run, bp - run);
+          }
+          cp += bp - run;
+          continue;
+        }
       }
-    }
-    cont = false;
-    while (*bp && cp < fbuf + MAXLINE) {
-      ucs4_t ucs;
-      size_t size;
-      int ret;
 
       if (!quote) {
         while (*bp == COMMENT_CHAR) {
@@ -232,30 +108,27 @@ static const char *getbuf_utf8(FILE * F)
           comment = true;
           ++bp;
         }
-      }
-
-      if (*bp == '\n' || *bp == '\r') {
-        /* line breaks, shmine breaks */
-        break;
+        if (IS_EOL(*bp)) {
+          break;
+        }
       }
 
       if (*bp == '"' || *bp == '\'') {
         if (quote == *bp) {
           quote = 0;
-          if (!comment && cp < fbuf + MAXLINE)
+          if (!comment)
             *cp++ = *bp;
           ++bp;
           continue;
         } else if (!quote) {
           quote = *bp++;
-          if (!comment && cp < fbuf + MAXLINE)
+          if (!comment)
             *cp++ = quote;
           continue;
         }
       }
 
       ret = unicode_utf8_to_ucs4(&ucs, bp, &size);
-
       if (ret != 0) {
         unicode_warning(bp);
         break;
@@ -263,66 +136,169 @@ static const char *getbuf_utf8(FILE * F)
 
       if (iswxspace((wint_t) ucs)) {
         if (!quote) {
-          bp += size;
-          ret = eatwhite(bp, &size);
-          bp += size;
-          if (!comment && *bp && *bp != COMMENT_CHAR && cp < fbuf + MAXLINE)
-            *(cp++) = ' ';
-          if (ret != 0) {
+          bp = eatwhite(bp + size, &err);
+          if (!comment && !IS_EOL(*bp) && *bp != COMMENT_CHAR)
+            *cp++ = ' ';
+          if (err != 0) {
             unicode_warning(bp);
             break;
           }
-        } else if (!comment) {
-          if (cp + size <= fbuf + MAXLINE) {
-            while (size--) {
-              *(cp++) = *(bp++);
-            }
-          } else
-            bp += size;
         } else {
+          if (!comment) {
+            memmove(cp, bp, size);
+            cp += size;
+          }
           bp += size;
         }
       } else if (iswcntrl((wint_t) ucs)) {
-        if (!comment && cp < fbuf + MAXLINE) {
+        if (!comment)
           *cp++ = '?';
-        }
         bp += size;
+      } else if (*bp == CONTINUE_CHAR) {
+        char *next = eatwhite(bp + 1, &err);
+        if (IS_EOL(*next)) {
+          bp = next;
+          cont = true;
+          break;
+        }
+        if (!comment)
+          *cp++ = *bp;
+        ++bp;
       } else {
-        if (*bp == CONTINUE_CHAR) {
-          const char *end;
-          eatwhite(bp + 1, &white);
-          end = bp + 1 + white;
-          if (*end == '\0') {
-            bp = end;
-            cont = true;
-            continue;
-          }
-          if (!comment && cp < fbuf + MAXLINE)
-            *cp++ = *bp++;
-          else
-            ++bp;
-        } else {
-          if (!comment && cp + size <= fbuf + MAXLINE) {
-            while (size--) {
-              *(cp++) = *(bp++);
-            }
-          } else {
-            bp += size;
-          }
+        if (!comment) {
+          memmove(cp, bp, size);
+          cp += size;
         }
+        bp += size;
       }
     }
-    if (cp == fbuf + MAXLINE) {
-      --cp;
+    eol = (bp < end) ? memchr(bp, '\n', end - bp) : NULL;
+    bp = eol ? (char *)eol + 1 : (char *)end;
+    if (cont) {
+      bp = eatwhite(bp, &err);
+    }
+  } while (cont && bp < end);
+  *cp = 0;
+  *nextp = bp;
+  return begin;
+}
+
+filereader *filereader_open(const char *filename, int encoding)
+{
+  filereader *fr;
+  FILE *F;
+  long size;
+  char *data;
+
+  F = fopen(filename, "rb");
+  if (!F) {
+    return NULL;
+  }
+  fseek(F, 0, SEEK_END);
+  size = ftell(F);
+  fseek(F, 0, SEEK_SET);
+  if (size < 0) {
+    fclose(F);
+    return NULL;
+  }
+  data = malloc((size_t)size + 1);
+  size = (long)fread(data, 1, (size_t)size, F);
+  fclose(F);
+  data[size] = 0;
+
+  if (encoding != XML_CHAR_ENCODING_UTF8) {
+    /* convert the whole file once, every character takes at most two bytes */
+    size_t inlen = (size_t)size, outlen = (size_t)size * 2;
+    char *utf8 = malloc(outlen + 1);
+    unicode_latin1_to_utf8(utf8, &outlen, data, &inlen);
+    free(data);
+    data = utf8;
+    size = (long)outlen;
+    data[size] = 0;
+  }
+
+  fr = malloc(sizeof(filereader));
+  fr->data = data;
+  fr->pos = data;
+  fr->end = data + size;
+  if (size >= 3 && memcmp(data, "\xef\xbb\xbf", 3) == 0) {
+    /* skip the UTF-8 byte order mark */
+    fr->pos += 3;
+  }
+  return fr;
+}
+
+const char *filereader_getline(filereader * fr)
+{
+  while (fr->pos < fr->end) {
+    const char *line = clean_line(fr->pos, fr->end, &fr->pos);
+    if (*line) {
+      return line;
     }
-    *cp = 0;
-  } while (cont || cp == fbuf);
-  return fbuf;
+  }
+  return NULL;
+}
+
+void filereader_close(filereader * fr)
+{
+  free(fr->data);
+  free(fr);
+}
+
+static bool is_continued(const char *bp, size_t len)
+{
+  while (len > 0 && isxspace(((const unsigned char *)bp)[len - 1]))
+    --len;
+  return len > 0 && bp[len - 1] == CONTINUE_CHAR;
 }
 
 const char *getbuf(FILE * F, int encoding)
 {
-  if (encoding == XML_CHAR_ENCODING_UTF8)
-    return getbuf_utf8(F);
-  return getbuf_latin1(F);
+  for (;;) {
+    size_t len = 0;
+    bool eof = false;
+    char *line, *next;
+
+    for (;;) {
+      size_t n;
+      if (fgets(lbuf + len, (int)(MAXLINE - len), F) == NULL) {
+        eof = true;
+        break;
+      }
+      n = strlen(lbuf + len);
+      if (len + n + 1 == MAXLINE && lbuf[MAXLINE - 2] != '\n') {
+        /* it wasn't enough space to finish the line, eat the rest */
+        int c;
+        do {
+          c = fgetc(F);
+        } while (c != EOF && c != '\n');
+        lbuf[len] = 0;
+        break;
+      }
+      len += n;
+      if (!is_continued(lbuf, len))
+        break;
+    }
+    if (len == 0) {
+      if (eof)
+        return NULL;
+      continue;
+    }
+
+    if (encoding == XML_CHAR_ENCODING_UTF8) {
+      line = lbuf;
+    } else {
+      size_t inlen = len, outlen = sizeof(fbuf) - 1;
+      unicode_latin1_to_utf8(fbuf, &outlen, lbuf, &inlen);
+      len = outlen;
+      line = fbuf;
+    }
+    line[len] = 0;
+    line = clean_line(line, line + len, &next);
+    if (*line) {
+      return line;
+    }
+    if (eof)
+      return NULL;
+  }
 }
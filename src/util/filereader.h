@@ -13,6 +13,13 @@
 extern "C" {
 #endif
 
+  typedef struct filereader filereader;
+
+  /* reads the whole file at once, lines are returned as pointers into it */
+  filereader *filereader_open(const char *filename, int encoding);
+  const char *filereader_getline(filereader * fr);
+  void filereader_close(filereader * fr);
+
   const char *getbuf(FILE *, int encoding);
 
 #ifdef __cplusplus
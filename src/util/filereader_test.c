@@ -0,0 +1,84 @@
+#include <platform.h>
+#include <CuTest.h>
+#include "filereader.h"
+
+#include <libxml/encoding.h>
+
+#include <stdio.h>
+#include <string.h>
+
+static const char *test_file = "filereader.test";
+
+static void write_file(const char *text)
+{
+  FILE *F = fopen(test_file, "wb");
+  fputs(text, F);
+  fclose(F);
+}
+
+static const char *lines =
+  "\xef\xbb\xbf" "ERESSEA abc \"geheim\"\n"
+  "  ; a comment\n"
+  "\n"
+  "EINHEIT  1\t; with a comment\r\n"
+  "BENENNEN EINHEIT \"Hallo   Welt\"\n"
+  "GIB 2 \\\n"
+  "   10 Silber\n"
+  "BESCHREIBE EINHEIT \"M\xc3\xa4nner ; und \\ Frauen\"";
+
+static void test_filereader_utf8(CuTest * tc)
+{
+  filereader *fr;
+
+  write_file(lines);
+  fr = filereader_open(test_file, XML_CHAR_ENCODING_UTF8);
+  CuAssertPtrNotNull(tc, fr);
+  CuAssertStrEquals(tc, "ERESSEA abc \"geheim\"", filereader_getline(fr));
+  CuAssertStrEquals(tc, "EINHEIT 1", filereader_getline(fr));
+  CuAssertStrEquals(tc, "BENENNEN EINHEIT \"Hallo   Welt\"", filereader_getline(fr));
+  CuAssertStrEquals(tc, "GIB 2 10 Silber", filereader_getline(fr));
+  CuAssertStrEquals(tc, "BESCHREIBE EINHEIT \"M\xc3\xa4nner ; und \\ Frauen\"", filereader_getline(fr));
+  CuAssertPtrEquals(tc, 0, (void *)filereader_getline(fr));
+  filereader_close(fr);
+  remove(test_file);
+}
+
+static void test_filereader_latin1(CuTest * tc)
+{
+  filereader *fr;
+
+  write_file("BENENNEN EINHEIT Gr\xfc\xdf" "e\n  ; M\xe4nner\nARBEITEN\n");
+  fr = filereader_open(test_file, XML_CHAR_ENCODING_8859_1);
+  CuAssertPtrNotNull(tc, fr);
+  CuAssertStrEquals(tc, "BENENNEN EINHEIT Gr\xc3\xbc\xc3\x9f" "e", filereader_getline(fr));
+  CuAssertStrEquals(tc, "ARBEITEN", filereader_getline(fr));
+  CuAssertPtrEquals(tc, 0, (void *)filereader_getline(fr));
+  filereader_close(fr);
+  remove(test_file);
+}
+
+static void test_getbuf(CuTest * tc)
+{
+  FILE *F;
+
+  /* the old interface gives the same results */
+  write_file(lines + 3);
+  F = fopen(test_file, "rb");
+  CuAssertStrEquals(tc, "ERESSEA abc \"geheim\"", getbuf(F, XML_CHAR_ENCODING_UTF8));
+  CuAssertStrEquals(tc, "EINHEIT 1", getbuf(F, XML_CHAR_ENCODING_UTF8));
+  CuAssertStrEquals(tc, "BENENNEN EINHEIT \"Hallo   Welt\"", getbuf(F, XML_CHAR_ENCODING_UTF8));
+  CuAssertStrEquals(tc, "GIB 2 10 Silber", getbuf(F, XML_CHAR_ENCODING_UTF8));
+  CuAssertStrEquals(tc, "BESCHREIBE EINHEIT \"M\xc3\xa4nner ; und \\ Frauen\"", getbuf(F, XML_CHAR_ENCODING_UTF8));
+  CuAssertPtrEquals(tc, 0, (void *)getbuf(F, XML_CHAR_ENCODING_UTF8));
+  fclose(F);
+  remove(test_file);
+}
+
+CuSuite *get_filereader_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_filereader_utf8);
+  SUITE_ADD_TEST(suite, test_filereader_latin1);
+  SUITE_ADD_TEST(suite, test_getbuf);
+  return suite;
+}
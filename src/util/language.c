@@ -99,30 +99,92 @@ void make_locales(const char *str)
   }
 }
 
-const char *locale_getstring(const locale * lang, const char *key)
+/* Translation keys are interned once, for all locales, into small integer
+ * ids. Each locale keeps its strings in an array indexed by that id, so
+ * callers that remember the id of a key never hash it again. Ids are never
+ * reused or freed. */
+static char **lkeys;
+static unsigned int *lhash;
+static unsigned int nkeys = 1, maxkeys;  /* id 0 is not a key */
+static unsigned int *lslots;
+static unsigned int nslots;
+
+static unsigned int *key_slot(const char *key, unsigned int hkey)
+{
+  unsigned int i = hkey & (nslots - 1);
+  while (lslots[i]) {
+    unsigned int id = lslots[i];
+    if (lhash[id] == hkey && strcmp(lkeys[id], key) == 0) {
+      break;
+    }
+    i = (i + 1) & (nslots - 1);
+  }
+  return lslots + i;
+}
+
+static unsigned int find_key(const char *key)
+{
+  if (nslots) {
+    return *key_slot(key, hashstring(key));
+  }
+  return 0;
+}
+
+unsigned int locale_key(const char *key)
 {
   unsigned int hkey = hashstring(key);
-  unsigned int id = hkey & (SMAXHASH - 1);
-  const struct locale_str *find;
+  unsigned int *slot;
 
+  assert(key && *key);
+  if ((nkeys + 1) * 2 > nslots) {
+    unsigned int id;
+    free(lslots);
+    nslots = nslots ? nslots * 2 : 4096;
+    lslots = (unsigned int *)calloc(nslots, sizeof(unsigned int));
+    for (id = 1; id != nkeys; ++id) {
+      *key_slot(lkeys[id], lhash[id]) = id;
+    }
+  }
+  slot = key_slot(key, hkey);
+  if (*slot == 0) {
+    if (nkeys >= maxkeys) {
+      maxkeys = maxkeys ? maxkeys * 2 : 2048;
+      lkeys = (char **)realloc(lkeys, maxkeys * sizeof(char *));
+      lhash = (unsigned int *)realloc(lhash, maxkeys * sizeof(unsigned int));
+    }
+    lkeys[nkeys] = _strdup(key);
+    lhash[nkeys] = hkey;
+    *slot = nkeys++;
+  }
+  return *slot;
+}
+
+static const char *get_string(const locale * lang, unsigned int id)
+{
+  return (id < lang->maxstrings) ? lang->strings[id] : NULL;
+}
+
+const char *locale_getstring(const locale * lang, const char *key)
+{
   assert(lang);
   if (key == NULL || *key == 0)
     return NULL;
-  find = lang->strings[id];
-  while (find) {
-    if (find->hashkey == hkey) {
-      if (find->nexthash == NULL) {
-        /* if this is the only entry with this hash, fine. */
-        assert(strcmp(key, find->key) == 0);
-        return find->str;
-      }
-      if (strcmp(key, find->key) == 0) {
-        return find->str;
-      }
+  return get_string(lang, find_key(key));
+}
+
+const char *locale_string_id(const locale * lang, unsigned int id)
+{
+  const char *str;
+
+  assert(lang);
+  str = get_string(lang, id);
+  if (!str && id) {
+    log_warning("missing translation for \"%s\" in locale %s\n", lkeys[id], lang->name);
+    if (lang->fallback) {
+      return locale_string_id(lang->fallback, id);
     }
-    find = find->nexthash;
   }
-  return NULL;
+  return str;
 }
 
 const char *locale_string(const locale * lang, const char *key)
@@ -130,64 +192,46 @@ const char *locale_string(const locale * lang, const char *key)
   assert(lang);
 
   if (key != NULL) {
-    unsigned int hkey = hashstring(key);
-    unsigned int id = hkey & (SMAXHASH - 1);
-    struct locale_str *find;
+    unsigned int id;
 
     if (*key == 0)
       return NULL;
-    find = lang->strings[id];
-    while (find) {
-      if (find->hashkey == hkey) {
-        if (find->nexthash == NULL) {
-          /* if this is the only entry with this hash, fine. */
-          assert(strcmp(key, find->key) == 0);
-          break;
-        }
-        if (strcmp(key, find->key) == 0)
-          break;
-      }
-      find = find->nexthash;
-    }
-    if (!find) {
+    id = find_key(key);
+    if (!id) {
       log_warning("missing translation for \"%s\" in locale %s\n", key, lang->name);
       if (lang->fallback) {
         return locale_string(lang->fallback, key);
       }
       return 0;
     }
-    return find->str;
+    return locale_string_id(lang, id);
   }
   return NULL;
 }
 
 void locale_setstring(locale * lang, const char *key, const char *value)
 {
-  unsigned int hkey = hashstring(key);
-  unsigned int id = hkey & (SMAXHASH - 1);
-  struct locale_str *find;
+  unsigned int id = locale_key(key);
   if (!lang) {
     lang = default_locale;
   }
   assert(lang);
-  find = lang->strings[id];
-  while (find) {
-    if (find->hashkey == hkey && strcmp(key, find->key) == 0)
-      break;
-    find = find->nexthash;
+  if (id >= lang->maxstrings) {
+    unsigned int size = lang->maxstrings ? lang->maxstrings : 1024;
+    while (size <= id)
+      size *= 2;
+    lang->strings = (char **)realloc(lang->strings, size * sizeof(char *));
+    memset(lang->strings + lang->maxstrings, 0,
+      (size - lang->maxstrings) * sizeof(char *));
+    lang->maxstrings = size;
   }
-  if (!find) {
-    find = calloc(1, sizeof(struct locale_str));
-    find->nexthash = lang->strings[id];
-    lang->strings[id] = find;
-    find->hashkey = hkey;
-    find->key = _strdup(key);
-    find->str = _strdup(value);
+  if (!lang->strings[id]) {
+    lang->strings[id] = _strdup(value);
   } else {
-    if (strcmp(find->str, value) != 0) {
+    if (strcmp(lang->strings[id], value) != 0) {
       log_error("duplicate translation '%s' for key %s\n", value, key);
     }
-    assert(!strcmp(find->str, value) || !"duplicate string for key");
+    assert(!strcmp(lang->strings[id], value) || !"duplicate string for key");
   }
 }
 
@@ -237,19 +281,24 @@ void ** get_translations(const struct locale *lang, int index)
 
 void free_locales(void)
 {
+  int l;
+  for (l = 0; l != MAXLOCALES; ++l) {
+    /* only these are filled with addprefix(), see init_translations */
+    freeprefixes(lstrs[l].tokens[UT_PARAMS]);
+    freeprefixes(lstrs[l].tokens[UT_KEYWORDS]);
+    freeprefixes(lstrs[l].tokens[UT_SKILLS]);
+    lstrs[l].tokens[UT_PARAMS] = NULL;
+    lstrs[l].tokens[UT_KEYWORDS] = NULL;
+    lstrs[l].tokens[UT_SKILLS] = NULL;
+  }
   while (locales) {
     int i;
     locale * next = locales->next;
 
-    for (i=0; i!=SMAXHASH; ++i) {
-      while (locales->strings[i]) {
-        struct locale_str * strings = locales->strings[i];
-        free(strings->key);
-        free(strings->str);
-        locales->strings[i] = strings->nexthash;
-        free(strings);
-      }
+    for (i=0; i!=(int)locales->maxstrings; ++i) {
+      free(locales->strings[i]);
     }
+    free(locales->strings);
     free(locales);
     locales = next;
   }
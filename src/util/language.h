@@ -37,6 +37,8 @@ extern "C" {
   extern const char *locale_getstring(const struct locale *lang,
     const char *key);
   extern const char *locale_string(const struct locale *lang, const char *key); /* does fallback */
+  extern unsigned int locale_key(const char *key);
+  extern const char *locale_string_id(const struct locale *lang, unsigned int id); /* does fallback */
   extern unsigned int locale_index(const struct locale *lang);
   extern const char *locale_name(const struct locale *lang);
 
@@ -5,20 +5,13 @@
  * feel that you need to include it, it's a sure sign that you're trying to
  * do something BAD. */
 
-#define SMAXHASH 2048
-typedef struct locale_str {
-  unsigned int hashkey;
-  struct locale_str *nexthash;
-  char *str;
-  char *key;
-} locale_str;
-
 typedef struct locale {
   unsigned int index;
   struct locale *next;
   unsigned int hashkey;
   const char *name;
-  struct locale_str *strings[SMAXHASH];
+  char **strings;               /* indexed by the id of the key */
+  unsigned int maxstrings;
   struct locale *fallback;
 } locale;
 
@@ -0,0 +1,48 @@
+#include <platform.h>
+#include <CuTest.h>
+#include "language.h"
+
+#include <string.h>
+
+static void test_locale_key(CuTest * tc)
+{
+  struct locale *de, *en;
+  unsigned int id;
+
+  free_locales();
+  default_locale = 0;
+  de = make_locale("de");
+  en = make_locale("en");
+  locale_setstring(de, "herp", "Herp");
+  locale_setstring(en, "herp", "herp");
+  locale_setstring(de, "derp", "Derp");
+
+  id = locale_key("herp");
+  CuAssertTrue(tc, id != 0);
+  CuAssertIntEquals(tc, id, locale_key("herp"));
+  CuAssertTrue(tc, id != locale_key("derp"));
+  CuAssertStrEquals(tc, "Herp", locale_string_id(de, id));
+  CuAssertStrEquals(tc, "herp", locale_string_id(en, id));
+  CuAssertStrEquals(tc, "Herp", locale_string(de, "herp"));
+  CuAssertStrEquals(tc, "Derp", locale_getstring(de, "derp"));
+  CuAssertPtrEquals(tc, 0, (void *)locale_getstring(en, "derp"));
+  CuAssertPtrEquals(tc, 0, (void *)locale_getstring(en, "nonexistent"));
+  CuAssertPtrEquals(tc, 0, (void *)locale_string_id(en, locale_key("derp")));
+  free_locales();
+  default_locale = 0;
+
+  /* ids survive the locales */
+  de = make_locale("de");
+  locale_setstring(de, "herp", "Herp");
+  CuAssertIntEquals(tc, id, locale_key("herp"));
+  CuAssertStrEquals(tc, "Herp", locale_string_id(de, id));
+  free_locales();
+  default_locale = 0;
+}
+
+CuSuite *get_language_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_locale_key);
+  return suite;
+}
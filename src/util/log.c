@@ -56,6 +56,11 @@ cp_convert(const char *format, char *buffer, size_t length, int codepage)
   while (pos + 1 < buffer + length && *input) {
     size_t length = 0;
     int result = 0;
+    if (*input > 0 && *input < 0x7F) {
+      /* ASCII is the same in every codepage */
+      *pos++ = *input++;
+      continue;
+    }
     if (codepage == 437) {
       result = unicode_utf8_to_cp437(pos, input, &length);
     } else if (codepage == 1252) {
@@ -10,14 +10,32 @@
 #define SPACE_REPLACEMENT '~'
 #define ESCAPE_CHAR       '\\'
 #define MAXTOKENSIZE      8192
+#define MAXCMDSIZE        16384
+#define MAXSTATES         8
 
 typedef struct parser_state {
   const char *current_token;
   char *current_cmd;
-  struct parser_state *next;
+  char buffer[MAXCMDSIZE];
 } parser_state;
 
-static parser_state *state;
+/* the global tokenizer is a fixed stack, so pushing and popping a state
+ * never allocates. the reentrant *_r functions do not use it at all. */
+static parser_state states[MAXSTATES];
+static parser_state *state = states;
+
+/* ASCII characters that are neither whitespace nor have a special meaning
+ * for the tokenizer. runs of these are copied without UTF-8 decoding. */
+static bool is_plain(unsigned char c)
+{
+  return c > ' ' && c < 0x80 && c != '"' && c != '\'' && c != ESCAPE_CHAR
+    && c != SPACE_REPLACEMENT;
+}
+
+static bool is_ascii_space(unsigned char c)
+{
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
 
 static int eatwhitespace_c(const char **str_p)
 {
@@ -30,7 +48,7 @@ static int eatwhitespace_c(const char **str_p)
   for (;;) {
     unsigned char utf8_character = (unsigned char)*str;
     if (~utf8_character & 0x80) {
-      if (!iswxspace(utf8_character))
+      if (!is_ascii_space(utf8_character))
         break;
       ++str;
     } else {
@@ -50,94 +68,140 @@ static int eatwhitespace_c(const char **str_p)
 
 void init_tokens_str(const char *initstr, char *cmd)
 {
-  if (state == NULL) {
-    state = malloc(sizeof(parser_state));
-  } else if (state->current_cmd)
+  if (state->current_cmd)
     free(state->current_cmd);
   state->current_cmd = cmd;
   state->current_token = initstr;
 }
 
+char *parser_buffer(size_t *size)
+{
+  *size = sizeof(state->buffer);
+  return state->buffer;
+}
+
 void parser_pushstate(void)
 {
-  parser_state *new_state = malloc(sizeof(parser_state));
-  new_state->current_cmd = NULL;
-  new_state->current_token = NULL;
-  new_state->next = state;
-  state = new_state;
+  assert(state + 1 < states + MAXSTATES || !"parser state stack overflow");
+  ++state;
+  state->current_cmd = NULL;
+  state->current_token = NULL;
 }
 
 void parser_popstate(void)
 {
-  parser_state *new_state = state->next;
-  if (state->current_cmd != NULL)
+  assert(state > states);
+  if (state->current_cmd != NULL) {
     free(state->current_cmd);
-  free(state);
-  state = new_state;
+    state->current_cmd = NULL;
+  }
+  --state;
+}
+
+bool parser_end_r(const char **str)
+{
+  eatwhitespace_c(str);
+  return **str == 0;
 }
 
 bool parser_end(void)
 {
-  eatwhitespace_c(&state->current_token);
-  return *state->current_token == 0;
+  return parser_end_r(&state->current_token);
 }
 
-void skip_token(void)
+void skip_token_r(const char **str)
 {
   char quotechar = 0;
-  eatwhitespace_c(&state->current_token);
+  const char *ctoken = *str;
 
-  while (*state->current_token) {
+  eatwhitespace_c(&ctoken);
+  while (*ctoken) {
     ucs4_t ucs;
     size_t len;
+    unsigned char utf8_character = (unsigned char)ctoken[0];
 
-    unsigned char utf8_character = (unsigned char)state->current_token[0];
+    if (quotechar == 0 && is_plain(utf8_character)) {
+      ++ctoken;
+      while (is_plain(*(unsigned char *)ctoken))
+        ++ctoken;
+      continue;
+    }
     if (~utf8_character & 0x80) {
       ucs = utf8_character;
-      ++state->current_token;
+      ++ctoken;
     } else {
-      int ret = unicode_utf8_to_ucs4(&ucs, state->current_token, &len);
+      int ret = unicode_utf8_to_ucs4(&ucs, ctoken, &len);
       if (ret == 0) {
-        state->current_token += len;
+        ctoken += len;
       } else {
-        log_warning("illegal character sequence in UTF8 string: %s\n", state->current_token);
+        log_warning("illegal character sequence in UTF8 string: %s\n", ctoken);
+        ucs = utf8_character;
+        ++ctoken;
       }
     }
     if (iswxspace((wint_t) ucs) && quotechar == 0) {
-      return;
+      break;
     } else {
       switch (utf8_character) {
         case '"':
         case '\'':
-          if (utf8_character == quotechar)
+          if (utf8_character == quotechar) {
+            *str = ctoken;
             return;
+          }
           quotechar = utf8_character;
           break;
         case ESCAPE_CHAR:
-          ++state->current_token;
+          if (*ctoken)
+            ++ctoken;
           break;
       }
     }
   }
+  *str = ctoken;
 }
 
-const char *parse_token(const char **str)
+void skip_token(void)
+{
+  skip_token_r(&state->current_token);
+}
+
+const char *parse_token_r(const char **str, char *lbuf, size_t size)
 {
-  static char lbuf[MAXTOKENSIZE];       /* STATIC_RESULT: used for return, not across calls */
   char *cursor = lbuf;
+  char *end = lbuf + size - 1;
   char quotechar = 0;
   bool escape = false;
   const char *ctoken = *str;
 
-  assert(ctoken);
+  assert(ctoken && size > 0);
 
   eatwhitespace_c(&ctoken);
-  while (*ctoken && cursor - lbuf < MAXTOKENSIZE - 1) {
+  /* a token that does not fit into the buffer is cut off, but the
+   * cursor still moves on to its end */
+  while (*ctoken) {
     ucs4_t ucs;
     size_t len;
     bool copy = false;
 
     unsigned char utf8_character = *(unsigned char *)ctoken;
+    if (!escape && is_plain(utf8_character)) {
+      /* fast path: copy a run of plain ASCII characters in one go */
+      const char *run = ctoken + 1;
+      size_t n;
+      while (is_plain(*(unsigned char *)run))
+        ++run;
+      n = run - ctoken;
+      if (n > (size_t)(end - cursor)) {
+        memcpy(cursor, ctoken, end - cursor);
+        cursor = end;
+      } else {
+        memcpy(cursor, ctoken, n);
+        cursor += n;
+      }
+      ctoken = run;
+      continue;
+    }
     if (~utf8_character & 0x80) {
       ucs = utf8_character;
       len = 1;
@@ -163,10 +227,13 @@ const char *parse_token(const char **str)
         quotechar = utf8_character;
         ++ctoken;
       } else {
-        *cursor++ = *ctoken++;
+        if (cursor < end)
+          *cursor++ = *ctoken;
+        ++ctoken;
       }
     } else if (utf8_character == SPACE_REPLACEMENT) {
-      *cursor++ = ' ';
+      if (cursor < end)
+        *cursor++ = ' ';
       ++ctoken;
     } else if (utf8_character == ESCAPE_CHAR) {
       escape = true;
@@ -175,8 +242,13 @@ const char *parse_token(const char **str)
       copy = true;
     }
     if (copy) {
-      memcpy(cursor, ctoken, len);
-      cursor += len;
+      if (cursor + len > end) {
+        /* no partial characters, and nothing after them */
+        end = cursor;
+      } else {
+        memcpy(cursor, ctoken, len);
+        cursor += len;
+      }
       ctoken += len;
     }
   }
@@ -186,6 +258,12 @@ const char *parse_token(const char **str)
   return lbuf;
 }
 
+const char *parse_token(const char **str)
+{
+  static char lbuf[MAXTOKENSIZE];       /* STATIC_RESULT: used for return, not across calls */
+  return parse_token_r(str, lbuf, sizeof(lbuf));
+}
+
 const char *getstrtoken(void)
 {
   return parse_token((const char **)&state->current_token);
@@ -21,6 +21,13 @@ extern "C" {
   extern void parser_popstate(void);
   extern bool parser_end(void);
   extern const char *getstrtoken(void);
+  extern char *parser_buffer(size_t *size);     /* scratch space owned by the current state */
+
+  /* reentrant versions: the caller owns the cursor and the token buffer */
+  extern const char *parse_token_r(const char **str, char *buffer,
+    size_t size);
+  extern void skip_token_r(const char **str);
+  extern bool parser_end_r(const char **str);
 
 #ifdef __cplusplus
 }
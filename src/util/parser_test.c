@@ -0,0 +1,95 @@
+#include <platform.h>
+#include <CuTest.h>
+#include "parser.h"
+
+#include <string.h>
+
+static void test_parse_token_r(CuTest * tc)
+{
+  char buffer[64];
+  const char *str = "  HELP 'Hello World' \"it's\" a~b c\\ d";
+  const char *tok;
+
+  tok = parse_token_r(&str, buffer, sizeof(buffer));
+  CuAssertPtrEquals(tc, buffer, (void *)tok);
+  CuAssertStrEquals(tc, "HELP", tok);
+  CuAssertStrEquals(tc, "Hello World", parse_token_r(&str, buffer, sizeof(buffer)));
+  CuAssertStrEquals(tc, "it's", parse_token_r(&str, buffer, sizeof(buffer)));
+  CuAssertStrEquals(tc, "a b", parse_token_r(&str, buffer, sizeof(buffer)));
+  CuAssertStrEquals(tc, "c d", parse_token_r(&str, buffer, sizeof(buffer)));
+  CuAssertTrue(tc, parser_end_r(&str));
+  CuAssertStrEquals(tc, "", parse_token_r(&str, buffer, sizeof(buffer)));
+}
+
+static void test_parse_token_utf8(CuTest * tc)
+{
+  char buffer[64];
+  /* non-breaking space separates tokens, umlauts are copied */
+  const char *str = "Gr\xc3\xbc\xc3\x9f" "e\xc2\xa0" "M\xc3\xa4nner";
+
+  CuAssertStrEquals(tc, "Gr\xc3\xbc\xc3\x9f" "e", parse_token_r(&str, buffer, sizeof(buffer)));
+  CuAssertStrEquals(tc, "M\xc3\xa4nner", parse_token_r(&str, buffer, sizeof(buffer)));
+  CuAssertTrue(tc, parser_end_r(&str));
+}
+
+static void test_parse_token_limit(CuTest * tc)
+{
+  char buffer[4];
+  const char *str = "abcdef \xc3\xa4\xc3\xa4";
+
+  CuAssertStrEquals(tc, "abc", parse_token_r(&str, buffer, sizeof(buffer)));
+  /* the rest of a long token is skipped, not read as the next one */
+  CuAssertStrEquals(tc, " \xc3\xa4\xc3\xa4", str);
+  /* never split a multi-byte character */
+  CuAssertStrEquals(tc, "\xc3\xa4", parse_token_r(&str, buffer, sizeof(buffer)));
+  CuAssertTrue(tc, parser_end_r(&str));
+
+  str = "'ab cd' ef";
+  CuAssertStrEquals(tc, "ab ", parse_token_r(&str, buffer, sizeof(buffer)));
+  CuAssertStrEquals(tc, "ef", parse_token_r(&str, buffer, sizeof(buffer)));
+}
+
+static void test_skip_token_r(CuTest * tc)
+{
+  const char *str = "MACHE 'Ein Schiff' \\\"x 5";
+
+  skip_token_r(&str);
+  CuAssertStrEquals(tc, "'Ein Schiff' \\\"x 5", str);
+  skip_token_r(&str);
+  CuAssertStrEquals(tc, " \\\"x 5", str);
+  skip_token_r(&str);
+  CuAssertStrEquals(tc, "5", str);
+  skip_token_r(&str);
+  CuAssertTrue(tc, parser_end_r(&str));
+}
+
+static void test_parser_state(CuTest * tc)
+{
+  size_t size;
+  char *buf;
+
+  init_tokens_str("GIB 1 2", NULL);
+  skip_token();
+  parser_pushstate();
+  buf = parser_buffer(&size);
+  CuAssertTrue(tc, size > 1000);
+  strcpy(buf, "NACH O W");
+  init_tokens_str(buf, NULL);
+  CuAssertStrEquals(tc, "NACH", getstrtoken());
+  CuAssertStrEquals(tc, "O", getstrtoken());
+  parser_popstate();
+  CuAssertStrEquals(tc, "1", getstrtoken());
+  CuAssertStrEquals(tc, "2", getstrtoken());
+  CuAssertTrue(tc, parser_end());
+}
+
+CuSuite *get_parser_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_parse_token_r);
+  SUITE_ADD_TEST(suite, test_parse_token_utf8);
+  SUITE_ADD_TEST(suite, test_parse_token_limit);
+  SUITE_ADD_TEST(suite, test_skip_token_r);
+  SUITE_ADD_TEST(suite, test_parser_state);
+  return suite;
+}
@@ -21,10 +21,12 @@ OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
 #include "rng.h"
 
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <math.h>
 #include <float.h>
 #include <ctype.h>
+#include <limits.h>
 
 #define M_PIl   3.1415926535897932384626433832795029L   /* pi */
 
@@ -47,16 +49,238 @@ double normalvariate(double mu, double sigma)
   return mu + z * sigma;
 }
 
+/* Anzahl der Versuche bis zum ersten Erfolg, jeder mit Wahrscheinlichkeit p.
+ * Inversion der geometrischen Verteilung, ein Zufallswert pro Aufruf. */
+int geometricvariate(double p)
+{
+  double u, k;
+  if (p >= 1.0) {
+    return 1;
+  }
+  assert(p > 0.0);
+  u = 1.0 - rng_double();       /* (0, 1] */
+  k = ceil(log(u) / log1p(-p));  /* log(1 - p) ist 0 fuer sehr kleine p */
+  if (k < 1.0) {
+    return 1;
+  }
+  return (k > INT_MAX) ? INT_MAX : (int)k;
+}
+
+/* log(k!) - Stirling, fuer BTRD */
+static double stirling_tail(int k)
+{
+  static const double fc[10] = {
+    0.08106146679532726, 0.04134069595540929, 0.02767792568499834,
+    0.02079067210376509, 0.01664469118982119, 0.01387612882307075,
+    0.01189670994589177, 0.01041126526197209, 0.009255462182712733,
+    0.008330563433362871
+  };
+  double r, rr;
+  if (k < 10) {
+    return fc[k];
+  }
+  r = 1.0 / (k + 1);
+  rr = r * r;
+  return (1.0 / 12 - (1.0 / 360 - rr / 1260) * rr) * r;
+}
+
+/* Hoermann, The generation of binomial random variates (BTRD), 1993.
+ * Fuer p <= 0.5 und n * p >= 10, konstante erwartete Laufzeit. */
+static int binomial_btrd(int n, double p)
+{
+  int m = (int)((n + 1) * p);
+  double r = p / (1.0 - p);
+  double nr = (n + 1) * r;
+  double npq = n * p * (1.0 - p);
+  double sqrt_npq = sqrt(npq);
+  double b = 1.15 + 2.53 * sqrt_npq;
+  double a = -0.0873 + 0.0248 * b + 0.01 * p;
+  double c = n * p + 0.5;
+  double alpha = (2.83 + 5.1 / b) * sqrt_npq;
+  double v_r = 0.92 - 4.2 / b;
+  double u_rv_r = 0.86 * v_r;
+
+  for (;;) {
+    double u, v, us, km;
+    int k;
+
+    v = rng_double();
+    if (v <= u_rv_r) {
+      u = v / v_r - 0.43;
+      return (int)floor((2 * a / (0.5 - fabs(u)) + b) * u + c);
+    }
+    if (v >= v_r) {
+      u = rng_double() - 0.5;
+    } else {
+      u = v / v_r - 0.93;
+      u = ((u < 0) ? -0.5 : 0.5) - u;
+      v = rng_double() * v_r;
+    }
+    us = 0.5 - fabs(u);
+    k = (int)floor((2 * a / us + b) * u + c);
+    if (k < 0 || k > n) {
+      continue;
+    }
+    v = v * alpha / (a / (us * us) + b);
+    km = fabs((double)(k - m));
+    if (km <= 15) {
+      /* f(k) = P(k) / P(m) rekursiv */
+      double f = 1.0;
+      int i;
+      if (m < k) {
+        for (i = m + 1; i <= k; ++i) {
+          f *= (nr / i - r);
+        }
+      } else if (m > k) {
+        for (i = k + 1; i <= m; ++i) {
+          v *= (nr / i - r);
+        }
+      }
+      if (v <= f) {
+        return k;
+      }
+    } else {
+      double rho, t, h, nm, nk;
+      v = log(v);
+      rho = (km / npq) * (((km / 3.0 + 0.625) * km + 1.0 / 6) * km / npq + 0.5);
+      t = -km * km / (2 * npq);
+      if (v < t - rho) {
+        return k;
+      }
+      if (v > t + rho) {
+        continue;
+      }
+      nm = n - m + 1;
+      h = (m + 0.5) * log((m + 1) / (r * nm)) + stirling_tail(m)
+        + stirling_tail(n - m);
+      nk = n - k + 1;
+      if (v <= h + (n + 1) * log(nm / nk) + (k + 0.5) * log(nk * r / (k + 1))
+        - stirling_tail(k) - stirling_tail(n - k)) {
+        return k;
+      }
+    }
+  }
+}
+
+/* kleine Mittelwerte: Inversion, im Mittel n * p Schritte */
+static int binomial_inversion(int n, double p)
+{
+  double q = 1.0 - p;
+  double s = p / q;
+  double a = (n + 1) * s;
+  double r0 = pow(q, n);
+
+  for (;;) {
+    double r = r0;
+    double u = rng_double();
+    int x = 0;
+    while (u > r) {
+      u -= r;
+      ++x;
+      if (x > n) {
+        break;
+      }
+      r *= (a / x - s);
+    }
+    if (x <= n) {
+      return x;
+    }
+  }
+}
+
+/* Anzahl der Erfolge bei n unabhaengigen Versuchen mit Wahrscheinlichkeit p.
+ * Ersetzt Schleifen, die fuer jede Person einmal wuerfeln. */
+int binomialvariate(int n, double p)
+{
+  if (n <= 0 || p <= 0.0) {
+    return 0;
+  }
+  if (p >= 1.0) {
+    return n;
+  }
+  if (p > 0.5) {
+    return n - binomialvariate(n, 1.0 - p);
+  }
+  if (n * p < 10) {
+    return binomial_inversion(n, p);
+  }
+  return binomial_btrd(n, p);
+}
+
+static double log_choose(int n, int k)
+{
+  return lgamma(n + 1.0) - lgamma(k + 1.0) - lgamma(n - k + 1.0);
+}
+
+/* Anzahl der guten unter n ohne Zuruecklegen gezogenen aus total, von
+ * denen good gut sind. Inversion, vom Modus aus abwechselnd nach oben und
+ * unten summiert, im Mittel etwa so viele Schritte wie die
+ * Standardabweichung. */
+int hypergeometricvariate(int n, int good, int total)
+{
+  int lo, hi, mode, up, down;
+  double pu, pd, u;
+
+  if (n <= 0 || good <= 0) {
+    return 0;
+  }
+  if (n >= total) {
+    return good;
+  }
+  if (good >= total) {
+    return n;
+  }
+  lo = MAX(0, n + good - total);
+  hi = MIN(n, good);
+  mode = (int)((n + 1.0) * (good + 1.0) / (total + 2.0));
+  mode = MAX(lo, MIN(hi, mode));
+  pu = exp(log_choose(good, mode) + log_choose(total - good, n - mode)
+    - log_choose(total, n));
+  pd = pu;
+  up = down = mode;
+  u = rng_double();
+  if (u < pu) {
+    return mode;
+  }
+  u -= pu;
+  while (up < hi || down > lo) {
+    if (up < hi) {
+      pu *= (double)(good - up) * (n - up)
+        / ((up + 1.0) * (total - good - n + up + 1.0));
+      ++up;
+      if (u < pu) {
+        return up;
+      }
+      u -= pu;
+    }
+    if (down > lo) {
+      pd *= (double)down * (total - good - n + down)
+        / ((good - down + 1.0) * (n - down + 1.0));
+      --down;
+      if (u < pd) {
+        return down;
+      }
+      u -= pd;
+    }
+  }
+  /* Rundungsfehler, die Summe war knapp unter 1 */
+  return mode;
+}
+
+/* Bei jedem Erfolg aendert sich p um mod. Statt jeden Versuch zu wuerfeln,
+ * wird die Anzahl der Versuche bis zum naechsten Erfolg gezogen. */
 int ntimespprob(int n, double p, double mod)
 {
   int count = 0;
-  int i;
 
-  for (i = 0; i < n && p > 0; i++) {
-    if (rng_double() < p) {
-      count++;
-      p += mod;
+  while (n > 0 && p > 0) {
+    int k = geometricvariate(p);
+    if (k > n) {
+      break;
     }
+    n -= k;
+    count++;
+    p += mod;
   }
   return count;
 }
@@ -67,3 +291,113 @@ bool chance(double x)
     return true;
   return rng_double() < x;
 }
+
+/* Gewichtete Ziehung ohne Zuruecklegen: Index i wird mit Wahrscheinlichkeit
+ * weight[i] / total gezogen, danach ist sein Gewicht um eins kleiner. Das
+ * entspricht dem Mischen einer Liste, in der jeder Index weight[i] mal
+ * vorkommt, braucht aber nur Platz fuer size Gewichte (Fenwick-Baum).
+ */
+void wdist_init(wdist * wd, const int *weights, int size)
+{
+  int i;
+  wd->size = size;
+  wd->total = 0;
+  wd->tree = (int *)malloc((size + 1) * sizeof(int));
+  wd->tree[0] = 0;
+  for (i = 1; i <= size; ++i) {
+    assert(weights[i - 1] >= 0);
+    wd->tree[i] = weights[i - 1];
+    wd->total += weights[i - 1];
+  }
+  for (i = 1; i <= size; ++i) {
+    int j = i + (i & -i);
+    if (j <= size) {
+      wd->tree[j] += wd->tree[i];
+    }
+  }
+}
+
+int wdist_draw(wdist * wd)
+{
+  int pos = 0, step = 1, x;
+  if (wd->total <= 0) {
+    return -1;
+  }
+  x = rng_int() % wd->total;
+  while (step * 2 <= wd->size) {
+    step *= 2;
+  }
+  for (; step; step /= 2) {
+    if (pos + step <= wd->size && wd->tree[pos + step] <= x) {
+      pos += step;
+      x -= wd->tree[pos];
+    }
+  }
+  /* pos ist jetzt der gezogene Index, im Baum 1-basiert: */
+  for (x = pos + 1; x <= wd->size; x += (x & -x)) {
+    --wd->tree[x];
+  }
+  --wd->total;
+  return pos;
+}
+
+static void wdist_add(wdist * wd, int i, int delta)
+{
+  for (++i; i <= wd->size; i += (i & -i)) {
+    wd->tree[i] += delta;
+  }
+  wd->total += delta;
+}
+
+/* Restgewicht von Index i, als Differenz zweier Praefixsummen */
+static int wdist_weight(const wdist * wd, int i)
+{
+  int w = 0, j;
+  for (j = i + 1; j > 0; j -= (j & -j)) {
+    w += wd->tree[j];
+  }
+  for (j = i; j > 0; j -= (j & -j)) {
+    w -= wd->tree[j];
+  }
+  return w;
+}
+
+/* Index i wird nicht mehr gezogen, z.B. weil sein request ohnehin
+ * scheitern wuerde. Die Reihenfolge der uebrigen aendert sich nicht. */
+void wdist_clear(wdist * wd, int i)
+{
+  wdist_add(wd, i, -wdist_weight(wd, i));
+}
+
+/* Die naechsten draws Ziehungen auf einmal: counts[i] ist, wie oft Index i
+ * dabei waere. Statt jede einzeln zu ziehen, wird nacheinander fuer jeden
+ * Index hypergeometrisch gewuerfelt (multivariat hypergeometrisch). */
+void wdist_split(wdist * wd, int draws, int *counts)
+{
+  int i, total = wd->total;
+  if (draws > total) {
+    draws = total;
+  }
+  for (i = 0; i != wd->size; ++i) {
+    int w, k;
+    if (draws <= 0) {
+      counts[i] = 0;
+      continue;
+    }
+    w = wdist_weight(wd, i);
+    k = hypergeometricvariate(draws, w, total);
+    counts[i] = k;
+    if (k > 0) {
+      wdist_add(wd, i, -k);
+    }
+    draws -= k;
+    total -= w;
+  }
+}
+
+void wdist_free(wdist * wd)
+{
+  free(wd->tree);
+  wd->tree = NULL;
+  wd->size = wd->total = 0;
+}
@@ -29,8 +29,22 @@ extern "C" {
   /* in rand.c: */
   extern double normalvariate(double mu, double sigma);
   extern int ntimespprob(int n, double p, double mod);
+  extern int binomialvariate(int n, double p);
+  extern int geometricvariate(double p);
+  extern int hypergeometricvariate(int n, int good, int total);
   extern bool chance(double x);
 
+  typedef struct wdist {
+    int *tree;
+    int size, total;
+  } wdist;
+
+  extern void wdist_init(wdist * wd, const int *weights, int size);
+  extern int wdist_draw(wdist * wd);
+  extern void wdist_split(wdist * wd, int draws, int *counts);
+  extern void wdist_clear(wdist * wd, int i);
+  extern void wdist_free(wdist * wd);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,340 @@
+#include <platform.h>
+#include <CuTest.h>
+#include "rand.h"
+#include "rng.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NTRIALS 20000
+#define NDRAWS 5
+
+static void test_wdist_exhausts(CuTest * tc)
+{
+  int weights[] = { 3, 0, 1, 5 };
+  int counts[4] = { 0, 0, 0, 0 };
+  wdist wd;
+  int i;
+
+  wdist_init(&wd, weights, 4);
+  CuAssertIntEquals(tc, 9, wd.total);
+  for (i = 0; i != 9; ++i) {
+    int k = wdist_draw(&wd);
+    CuAssertTrue(tc, k >= 0 && k < 4);
+    ++counts[k];
+  }
+  CuAssertIntEquals(tc, -1, wdist_draw(&wd));
+  CuAssertIntEquals(tc, 0, memcmp(weights, counts, sizeof(counts)));
+  wdist_free(&wd);
+}
+
+/* the old expandorders: one entry per unit of weight, mixed by the old
+ * scramble(), which swaps every entry with a random one. That favours
+ * some positions, so the requests come in random order, like the units
+ * of a region do. */
+static void expanded_draws(const int *weights, int size, int total,
+  int draws, int *counts)
+{
+  int *items = (int *)malloc(total * sizeof(int));
+  int *order = (int *)malloc(size * sizeof(int));
+  int i, j, n = 0;
+  for (i = 0; i != size; ++i) {
+    order[i] = i;
+  }
+  for (i = size - 1; i > 0; --i) {
+    int k = rng_int() % (i + 1);
+    int t = order[i];
+    order[i] = order[k];
+    order[k] = t;
+  }
+  for (i = 0; i != size; ++i) {
+    for (j = 0; j != weights[order[i]]; ++j) {
+      items[n++] = order[i];
+    }
+  }
+  for (j = 0; j != total; ++j) {
+    int k = rng_int() % total;
+    int t = items[j];
+    items[j] = items[k];
+    items[k] = t;
+  }
+  for (i = 0; i != draws; ++i) {
+    ++counts[items[i]];
+  }
+  free(order);
+  free(items);
+}
+
+static void test_wdist_matches_shuffle(CuTest * tc)
+{
+  int weights[] = { 1, 2, 3, 4 };
+  int old_counts[4] = { 0, 0, 0, 0 };
+  int new_counts[4] = { 0, 0, 0, 0 };
+  int first[4] = { 0, 0, 0, 0 };
+  int t, i;
+
+  for (t = 0; t != NTRIALS; ++t) {
+    wdist wd;
+    wdist_init(&wd, weights, 4);
+    for (i = 0; i != NDRAWS; ++i) {
+      int k = wdist_draw(&wd);
+      if (i == 0) {
+        ++first[k];
+      }
+      ++new_counts[k];
+    }
+    wdist_free(&wd);
+    expanded_draws(weights, 4, 10, NDRAWS, old_counts);
+  }
+  for (i = 0; i != 4; ++i) {
+    /* hypergeometric mean of NDRAWS draws is NDRAWS * w / total */
+    double expect = NDRAWS * weights[i] / 10.0;
+    CuAssertDblEquals(tc, weights[i] / 10.0, first[i] / (double)NTRIALS, 0.02);
+    CuAssertDblEquals(tc, expect, new_counts[i] / (double)NTRIALS, 0.05);
+    CuAssertDblEquals(tc, old_counts[i] / (double)NTRIALS,
+      new_counts[i] / (double)NTRIALS, 0.05);
+  }
+}
+
+static double hypergeometric_p(int k, int n, int good, int total)
+{
+  return exp(lgamma(good + 1.0) - lgamma(k + 1.0) - lgamma(good - k + 1.0)
+    + lgamma(total - good + 1.0) - lgamma(n - k + 1.0)
+    - lgamma(total - good - n + k + 1.0)
+    - lgamma(total + 1.0) + lgamma(n + 1.0) + lgamma(total - n + 1.0));
+}
+
+/* the whole distribution of shares, split at once, against the old
+ * expand-and-scramble. scramble() is not quite fair, it gives the big
+ * requests up to two percent more often than the hypergeometric
+ * distribution would; the split matches the latter. */
+static void test_wdist_split_matches_scramble(CuTest * tc)
+{
+  int weights[] = { 5, 10, 20, 40, 25 };
+  int old_hist[5][31], new_hist[5][31];
+  int t, i, k;
+
+  memset(old_hist, 0, sizeof(old_hist));
+  memset(new_hist, 0, sizeof(new_hist));
+  for (t = 0; t != NTRIALS; ++t) {
+    int old_counts[5] = { 0, 0, 0, 0, 0 };
+    int new_counts[5];
+    int sum = 0;
+    wdist wd;
+    wdist_init(&wd, weights, 5);
+    wdist_split(&wd, 30, new_counts);
+    CuAssertIntEquals(tc, 70, wd.total);
+    wdist_free(&wd);
+    expanded_draws(weights, 5, 100, 30, old_counts);
+    for (i = 0; i != 5; ++i) {
+      CuAssertTrue(tc, new_counts[i] >= 0 && new_counts[i] <= weights[i]);
+      sum += new_counts[i];
+      ++old_hist[i][old_counts[i]];
+      ++new_hist[i][new_counts[i]];
+    }
+    CuAssertIntEquals(tc, 30, sum);
+  }
+  for (i = 0; i != 5; ++i) {
+    for (k = 0; k <= 30 && k <= weights[i]; ++k) {
+      CuAssertDblEquals(tc, old_hist[i][k] / (double)NTRIALS,
+        new_hist[i][k] / (double)NTRIALS, 0.03);
+      CuAssertDblEquals(tc, hypergeometric_p(k, 30, weights[i], 100),
+        new_hist[i][k] / (double)NTRIALS, 0.01);
+    }
+  }
+}
+
+static void test_wdist_clear(CuTest * tc)
+{
+  int weights[] = { 3, 4, 5 };
+  wdist wd;
+  int i;
+
+  wdist_init(&wd, weights, 3);
+  wdist_clear(&wd, 1);
+  CuAssertIntEquals(tc, 8, wd.total);
+  for (i = 0; i != 8; ++i) {
+    CuAssertTrue(tc, wdist_draw(&wd) != 1);
+  }
+  CuAssertIntEquals(tc, -1, wdist_draw(&wd));
+  wdist_free(&wd);
+}
+
+/* a rich region: 2000 tax collectors asking for 100 million pieces in total,
+ * of which only the first million can be paid. */
+static void test_wdist_wealthy(CuTest * tc)
+{
+  int weights[2000];
+  int counts[2000];
+  int i, sum = 0, draws = 1000000;
+  wdist wd;
+
+  for (i = 0; i != 2000; ++i) {
+    weights[i] = 50000;
+  }
+  wdist_init(&wd, weights, 2000);
+  CuAssertIntEquals(tc, 100000000, wd.total);
+  wdist_split(&wd, draws, counts);
+  CuAssertIntEquals(tc, 100000000 - draws, wd.total);
+  for (i = 0; i != 2000; ++i) {
+    /* mean 500, standard deviation about 22 */
+    CuAssertTrue(tc, counts[i] > 350 && counts[i] < 650);
+    sum += counts[i];
+  }
+  CuAssertIntEquals(tc, draws, sum);
+  wdist_free(&wd);
+}
+
+/* mean and variance of the hypergeometric distribution, within a few
+ * standard errors */
+static void check_hypergeometric(CuTest * tc, int n, int good, int total)
+{
+  double p = good / (double)total;
+  double mean = n * p;
+  double var = mean * (1 - p) * (total - n) / (total - 1.0);
+  double sum = 0, sum2 = 0;
+  int t;
+  for (t = 0; t != NTRIALS; ++t) {
+    int k = hypergeometricvariate(n, good, total);
+    CuAssertTrue(tc, k >= 0 && k <= n && k <= good);
+    CuAssertTrue(tc, n - k <= total - good);
+    sum += k;
+    sum2 += (double)k * k;
+  }
+  sum /= NTRIALS;
+  sum2 = sum2 / NTRIALS - sum * sum;
+  CuAssertDblEquals(tc, mean, sum, 5 * sqrt(var / NTRIALS) + 1e-9);
+  CuAssertDblEquals(tc, var, sum2, 0.06 * var + 1e-9);
+}
+
+static void test_hypergeometric(CuTest * tc)
+{
+  CuAssertIntEquals(tc, 0, hypergeometricvariate(0, 5, 10));
+  CuAssertIntEquals(tc, 0, hypergeometricvariate(5, 0, 10));
+  CuAssertIntEquals(tc, 4, hypergeometricvariate(10, 4, 10));
+  CuAssertIntEquals(tc, 7, hypergeometricvariate(7, 10, 10));
+  /* only five bad ones, so eight draws find three good ones at least */
+  CuAssertTrue(tc, hypergeometricvariate(8, 5, 10) >= 3);
+  check_hypergeometric(tc, 30, 40, 100);
+  check_hypergeometric(tc, 3, 2, 1000);
+  check_hypergeometric(tc, 990, 500, 1000);
+  check_hypergeometric(tc, 1000000, 50000, 100000000);
+}
+
+/* compare mean and variance of n trials with probability p to the
+ * binomial distribution, within a few standard errors */
+static void check_binomial(CuTest * tc, int n, double p, int trials)
+{
+  double sum = 0, sum2 = 0, mean, var;
+  double mu = n * p, sigma2 = n * p * (1 - p);
+  int t;
+
+  for (t = 0; t != trials; ++t) {
+    int k = binomialvariate(n, p);
+    CuAssertTrue(tc, k >= 0 && k <= n);
+    sum += k;
+    sum2 += (double)k * k;
+  }
+  mean = sum / trials;
+  var = sum2 / trials - mean * mean;
+  CuAssertDblEquals(tc, mu, mean, 5 * sqrt(sigma2 / trials) + 1e-9);
+  CuAssertDblEquals(tc, sigma2, var, 0.1 * sigma2 + 1e-9);
+}
+
+static void test_binomial_moments(CuTest * tc)
+{
+  CuAssertIntEquals(tc, 0, binomialvariate(0, 0.5));
+  CuAssertIntEquals(tc, 0, binomialvariate(100, 0));
+  CuAssertIntEquals(tc, 100, binomialvariate(100, 1));
+  check_binomial(tc, 1, 0.25, NTRIALS);
+  check_binomial(tc, 40, 0.1, NTRIALS);
+  check_binomial(tc, 20, 0.9, NTRIALS);
+  check_binomial(tc, 1000, 0.25, NTRIALS);
+  check_binomial(tc, 100000, 0.001, NTRIALS);
+  check_binomial(tc, 10000000, 0.00075, NTRIALS);
+}
+
+/* the histogram must match the one of the per-trial loop it replaces */
+static void test_binomial_matches_loop(CuTest * tc)
+{
+  const int n = 60;
+  const double p = 0.3;
+  int old_counts[61], new_counts[61];
+  int t, i;
+
+  memset(old_counts, 0, sizeof(old_counts));
+  memset(new_counts, 0, sizeof(new_counts));
+  for (t = 0; t != NTRIALS; ++t) {
+    int k = 0;
+    for (i = 0; i != n; ++i) {
+      if (rng_double() < p) {
+        ++k;
+      }
+    }
+    ++old_counts[k];
+    ++new_counts[binomialvariate(n, p)];
+  }
+  for (i = 0; i <= n; ++i) {
+    CuAssertDblEquals(tc, old_counts[i] / (double)NTRIALS,
+      new_counts[i] / (double)NTRIALS, 0.012);
+  }
+}
+
+static void test_geometric(CuTest * tc)
+{
+  double sum = 0;
+  int t;
+
+  CuAssertIntEquals(tc, 1, geometricvariate(1.0));
+  for (t = 0; t != NTRIALS; ++t) {
+    int k = geometricvariate(0.2);
+    CuAssertTrue(tc, k >= 1);
+    sum += k;
+  }
+  /* mean 1/p = 5, standard deviation sqrt(1-p)/p = 4.5 */
+  CuAssertDblEquals(tc, 5.0, sum / NTRIALS, 0.2);
+  /* 1 - p rounds to 1.0 here, a success is still very far away */
+  for (t = 0; t != 10; ++t) {
+    CuAssertTrue(tc, geometricvariate(1e-20) > 1000000);
+  }
+}
+
+/* ntimespprob with a changing probability against the old per-trial loop */
+static void test_ntimespprob(CuTest * tc)
+{
+  double old_sum = 0, new_sum = 0;
+  int t;
+
+  CuAssertIntEquals(tc, 0, ntimespprob(100, 0, 0));
+  CuAssertIntEquals(tc, 10, ntimespprob(10, 1.0, 0));
+  CuAssertIntEquals(tc, 4, ntimespprob(1000, 0.5, -0.125));
+  for (t = 0; t != NTRIALS; ++t) {
+    double p = 0.4;
+    int i, count = 0;
+    for (i = 0; i < 200 && p > 0; i++) {
+      if (rng_double() < p) {
+        count++;
+        p -= 0.01;
+      }
+    }
+    old_sum += count;
+    new_sum += ntimespprob(200, 0.4, -0.01);
+  }
+  CuAssertDblEquals(tc, old_sum / NTRIALS, new_sum / NTRIALS, 0.2);
+}
+
+CuSuite *get_rand_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_wdist_exhausts);
+  SUITE_ADD_TEST(suite, test_wdist_matches_shuffle);
+  SUITE_ADD_TEST(suite, test_wdist_split_matches_scramble);
+  SUITE_ADD_TEST(suite, test_wdist_clear);
+  SUITE_ADD_TEST(suite, test_wdist_wealthy);
+  SUITE_ADD_TEST(suite, test_hypergeometric);
+  SUITE_ADD_TEST(suite, test_binomial_moments);
+  SUITE_ADD_TEST(suite, test_binomial_matches_loop);
+  SUITE_ADD_TEST(suite, test_geometric);
+  SUITE_ADD_TEST(suite, test_ntimespprob);
+  return suite;
+}
@@ -28,14 +28,20 @@ typedef struct unresolved {
   /* address to pass to the resolve-function */
   variant data;
   /* information on how to resolve the missing object */
-  resolve_fun resolve;
-  /* function to resolve the unknown object */
 } unresolved;
 
+/* all references that use the same resolve-function are kept together */
+typedef struct ur_queue {
+  resolve_fun resolve;
+  /* function to resolve the unknown objects */
+  unresolved *list;
+  int size, count;
+} ur_queue;
+
 #define BLOCKSIZE 1024
-static unresolved *ur_list;
-static unresolved *ur_begin;
-static unresolved *ur_current;
+#define MAXKINDS 64
+static ur_queue ur_queues[MAXKINDS];
+static int ur_nqueues;
 
 variant read_int(struct storage *store)
 {
@@ -56,38 +62,59 @@ read_reference(void *address, storage * store, read_fun reader,
   return result;
 }
 
-void ur_add(variant data, void *ptrptr, resolve_fun fun)
+static ur_queue *ur_find(resolve_fun fun)
 {
-  if (ur_list == NULL) {
-    ur_list = malloc(BLOCKSIZE * sizeof(unresolved));
-    ur_begin = ur_current = ur_list;
-  } else if (ur_current - ur_begin == BLOCKSIZE - 1) {
-    ur_begin = malloc(BLOCKSIZE * sizeof(unresolved));
-    ur_current->data.v = ur_begin;
-    ur_current = ur_begin;
+  static int last = 0;
+  int i;
+
+  if (last < ur_nqueues && ur_queues[last].resolve == fun) {
+    return ur_queues + last;
+  }
+  for (i = 0; i != ur_nqueues; ++i) {
+    if (ur_queues[i].resolve == fun) {
+      last = i;
+      return ur_queues + i;
+    }
   }
-  ur_current->data = data;
-  ur_current->resolve = fun;
-  ur_current->ptrptr = ptrptr;
+  assert(ur_nqueues < MAXKINDS);
+  last = ur_nqueues++;
+  ur_queues[last].resolve = fun;
+  return ur_queues + last;
+}
+
+void ur_add(variant data, void *ptrptr, resolve_fun fun)
+{
+  ur_queue *q = ur_find(fun);
+  unresolved *ur;
 
-  ++ur_current;
-  ur_current->resolve = NULL;
-  ur_current->data.v = NULL;
+  if (q->count == q->size) {
+    q->size = q->size ? q->size * 2 : BLOCKSIZE;
+    q->list = realloc(q->list, q->size * sizeof(unresolved));
+  }
+  ur = q->list + q->count++;
+  ur->data = data;
+  ur->ptrptr = ptrptr;
 }
 
+/* Resolves the references one kind after the other, in the order the
+ * kinds were first used, so a resolver can rely on any kind that was added
+ * before it: cw_read adds the wall before the buddy that looks at it.
+ * Within a kind, references are resolved in the order they were added. */
 void resolve(void)
 {
-  unresolved *ur = ur_list;
-  while (ur) {
-    if (ur->resolve == NULL) {
-      ur = ur->data.v;
-      free(ur_list);
-      ur_list = ur;
-      continue;
+  int k;
+
+  for (k = 0; k != ur_nqueues; ++k) {
+    ur_queue *q = ur_queues + k;
+    resolve_fun fun = q->resolve;
+    int i;
+
+    for (i = 0; i != q->count; ++i) {
+      fun(q->list[i].data, q->list[i].ptrptr);
     }
-    ur->resolve(ur->data, ur->ptrptr);
-    ++ur;
+    free(q->list);
+    q->list = NULL;
+    q->size = q->count = 0;
   }
-  free(ur_list);
-  ur_list = NULL;
+  ur_nqueues = 0;
 }
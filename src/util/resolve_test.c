@@ -0,0 +1,70 @@
+#include <platform.h>
+#include "resolve.h"
+
+#include <CuTest.h>
+
+static int calls[8];
+static int ncalls;
+
+static int resolve_first(variant data, void *address)
+{
+  calls[ncalls++] = data.i;
+  *(int *)address = data.i;
+  return 0;
+}
+
+static int resolve_second(variant data, void *address)
+{
+  calls[ncalls++] = -data.i;
+  *(int *)address = -data.i;
+  return 0;
+}
+
+static void test_resolve_order(CuTest * tc)
+{
+  int result[5] = { 0, 0, 0, 0, 0 };
+  variant var;
+
+  ncalls = 0;
+  var.i = 3;
+  ur_add(var, result + 0, resolve_first);
+  var.i = 2;
+  ur_add(var, result + 1, resolve_second);
+  var.i = 1;
+  ur_add(var, result + 2, resolve_first);
+  var.i = 1;
+  ur_add(var, result + 3, resolve_second);
+  var.i = 2;
+  ur_add(var, result + 4, resolve_first);
+  resolve();
+
+  CuAssertIntEquals(tc, 3, result[0]);
+  CuAssertIntEquals(tc, -2, result[1]);
+  CuAssertIntEquals(tc, 1, result[2]);
+  CuAssertIntEquals(tc, -1, result[3]);
+  CuAssertIntEquals(tc, 2, result[4]);
+
+  /* one kind after the other, in the order of first use */
+  CuAssertIntEquals(tc, 5, ncalls);
+  CuAssertIntEquals(tc, 3, calls[0]);
+  CuAssertIntEquals(tc, 1, calls[1]);
+  CuAssertIntEquals(tc, 2, calls[2]);
+  CuAssertIntEquals(tc, -2, calls[3]);
+  CuAssertIntEquals(tc, -1, calls[4]);
+
+  /* the queue is empty after resolving */
+  ncalls = 0;
+  resolve();
+  CuAssertIntEquals(tc, 0, ncalls);
+  var.i = 7;
+  ur_add(var, result + 0, resolve_second);
+  resolve();
+  CuAssertIntEquals(tc, -7, result[0]);
+}
+
+CuSuite *get_resolve_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_resolve_order);
+  return suite;
+}
@@ -261,3 +261,142 @@ int findtoken(const void * root, const char *key, variant * result)
   log_debug("findtoken | token not found '%s'\n", key);
   return E_TOK_NOMATCH;
 }
+
+/* A prefix table maps every prefix of every word to the first word (in
+ * sort order) that starts with it, like a prefix search in a critbit tree
+ * would. Words are stored transliterated, so a lookup is one pass over the
+ * input to fold and hash it, and one probe into an open hash table. */
+typedef struct prefix {
+  const char *word;
+  unsigned int hash;
+  unsigned int len;
+  int id;
+} prefix;
+
+typedef struct prefix_table {
+  prefix *prefixes;
+  unsigned int size, count;     /* size is a power of two */
+  char **words;
+  int nwords;
+} prefix_table;
+
+#define PREFIX_SEED 2166136261U
+#define PREFIX_HASH(h, c) (((h) ^ (unsigned char)(c)) * 16777619U)
+
+static prefix *prefix_slot(prefix_table * pt, unsigned int hash,
+  const char *str, unsigned int len)
+{
+  unsigned int i = hash & (pt->size - 1);
+  for (;;) {
+    prefix *p = pt->prefixes + i;
+    if (!p->word || (p->hash == hash && p->len == len
+        && memcmp(p->word, str, len) == 0)) {
+      return p;
+    }
+    i = (i + 1) & (pt->size - 1);
+  }
+}
+
+static void prefix_grow(prefix_table * pt)
+{
+  prefix *old = pt->prefixes;
+  unsigned int i, size = pt->size;
+
+  pt->size = size ? size * 2 : 64;
+  pt->prefixes = (prefix *)calloc(pt->size, sizeof(prefix));
+  for (i = 0; i != size; ++i) {
+    if (old[i].word) {
+      *prefix_slot(pt, old[i].hash, old[i].word, old[i].len) = old[i];
+    }
+  }
+  free(old);
+}
+
+void addprefix(void **root, const char *str, int id)
+{
+  prefix_table *pt = (prefix_table *)*root;
+  unsigned int len, hash = PREFIX_SEED;
+  char *word;
+
+  assert(root && str);
+  if (!pt) {
+    *root = pt = (prefix_table *)calloc(1, sizeof(prefix_table));
+  }
+  word = _strdup(str);
+  pt->words = (char **)realloc(pt->words, (pt->nwords + 1) * sizeof(char *));
+  pt->words[pt->nwords++] = word;
+  for (len = 1; word[len - 1]; ++len) {
+    prefix *p;
+    hash = PREFIX_HASH(hash, word[len - 1]);
+    if ((pt->count + 1) * 2 > pt->size) {
+      prefix_grow(pt);
+    }
+    p = prefix_slot(pt, hash, word, len);
+    if (!p->word) {
+      p->word = word;
+      p->hash = hash;
+      p->len = len;
+      p->id = id;
+      ++pt->count;
+    } else if (strcmp(word, p->word) < 0) {
+      p->word = word;
+      p->id = id;
+    }
+  }
+}
+
+int findprefix(const void *root, const char *str, int *id)
+{
+  const prefix_table *pt = (const prefix_table *)root;
+  unsigned int i, len, hash = PREFIX_SEED;
+  char buffer[PREFIX_MAXLEN];
+
+  if (!pt || !str) {
+    return E_TOK_NOMATCH;
+  }
+  /* fold plain ASCII while hashing, transliterate everything else */
+  for (len = 0; str[len]; ++len) {
+    char c = str[len];
+    if ((c & 0x80) || len + 1 == sizeof(buffer)) {
+      break;
+    }
+    buffer[len] = (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    hash = PREFIX_HASH(hash, buffer[len]);
+  }
+  if (str[len]) {
+    if (!transliterate(buffer, sizeof(buffer), str)) {
+      return E_TOK_NOMATCH;
+    }
+    hash = PREFIX_SEED;
+    for (len = 0; buffer[len]; ++len) {
+      hash = PREFIX_HASH(hash, buffer[len]);
+    }
+  }
+  if (len == 0 || pt->size == 0) {
+    return E_TOK_NOMATCH;
+  }
+  for (i = hash & (pt->size - 1);; i = (i + 1) & (pt->size - 1)) {
+    const prefix *p = pt->prefixes + i;
+    if (!p->word) {
+      return E_TOK_NOMATCH;
+    }
+    if (p->hash == hash && p->len == len && memcmp(p->word, buffer, len) == 0) {
+      *id = p->id;
+      return E_TOK_SUCCESS;
+    }
+  }
+}
+
+void freeprefixes(void *root)
+{
+  prefix_table *pt = (prefix_table *)root;
+  if (pt) {
+    int i;
+    for (i = 0; i != pt->nwords; ++i) {
+      free(pt->words[i]);
+    }
+    free(pt->words);
+    free(pt->prefixes);
+    free(pt);
+  }
+}
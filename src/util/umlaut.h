@@ -35,6 +35,13 @@ extern "C" {
 
   char * transliterate(char * out, size_t size, const char * in);
 
+  /* prefix lookup for transliterated words, which are at most
+   * PREFIX_MAXLEN-1 bytes long, both when added and when looked up */
+#define PREFIX_MAXLEN 128
+  void addprefix(void **root, const char *str, int id);
+  int findprefix(const void *root, const char *str, int *id);
+  void freeprefixes(void *root);
+
   typedef struct local_names {
     struct local_names *next;
     const struct locale *lang;
@@ -68,10 +68,69 @@ static void test_umlaut(CuTest * tc)
   freetokens(tokens);
 }
 
+static void test_prefix(CuTest * tc)
+{
+  void * tokens = 0;
+  int id = -1;
+
+  CuAssertIntEquals(tc, E_TOK_NOMATCH, findprefix(tokens, "herp", &id));
+  addprefix(&tokens, "herpderp", 1);
+  addprefix(&tokens, "herp", 2);
+  addprefix(&tokens, "derp", 3);
+  addprefix(&tokens, "derpina", 4);
+  addprefix(&tokens, "kaempfe", 5);
+  addprefix(&tokens, "dee", 6);
+
+  /* an exact match wins over longer words */
+  CuAssertIntEquals(tc, E_TOK_SUCCESS, findprefix(tokens, "herp", &id));
+  CuAssertIntEquals(tc, 2, id);
+  CuAssertIntEquals(tc, E_TOK_SUCCESS, findprefix(tokens, "HERPD", &id));
+  CuAssertIntEquals(tc, 1, id);
+  /* ambiguous prefixes match the first word in sort order */
+  CuAssertIntEquals(tc, E_TOK_SUCCESS, findprefix(tokens, "De", &id));
+  CuAssertIntEquals(tc, 6, id);
+  CuAssertIntEquals(tc, E_TOK_SUCCESS, findprefix(tokens, "derpi", &id));
+  CuAssertIntEquals(tc, 4, id);
+  /* input is transliterated */
+  CuAssertIntEquals(tc, E_TOK_SUCCESS, findprefix(tokens, "K\xc3\xa4mpf", &id));
+  CuAssertIntEquals(tc, 5, id);
+
+  CuAssertIntEquals(tc, E_TOK_NOMATCH, findprefix(tokens, "", &id));
+  CuAssertIntEquals(tc, E_TOK_NOMATCH, findprefix(tokens, "herpderpa", &id));
+  CuAssertIntEquals(tc, E_TOK_NOMATCH, findprefix(tokens, "x", &id));
+  freeprefixes(tokens);
+}
+
+/* words up to PREFIX_MAXLEN-1 bytes are found the way they were added */
+static void test_prefix_long(CuTest * tc)
+{
+  void *tokens = 0;
+  char word[PREFIX_MAXLEN + 1], buffer[PREFIX_MAXLEN];
+  int id;
+
+  memset(word, 'x', PREFIX_MAXLEN - 1);
+  word[0] = '\xc3';
+  word[1] = '\xa4';
+  word[PREFIX_MAXLEN - 1] = 0;
+  /* the umlaut transliterates into two letters */
+  CuAssertPtrEquals(tc, buffer, transliterate(buffer, sizeof(buffer), word));
+  addprefix(&tokens, buffer, 7);
+  CuAssertIntEquals(tc, E_TOK_SUCCESS, findprefix(tokens, word, &id));
+  CuAssertIntEquals(tc, 7, id);
+  CuAssertIntEquals(tc, E_TOK_SUCCESS, findprefix(tokens, buffer, &id));
+  word[PREFIX_MAXLEN - 1] = 'x';
+  word[PREFIX_MAXLEN] = 0;
+  CuAssertPtrEquals(tc, 0, transliterate(buffer, sizeof(buffer), word));
+  CuAssertIntEquals(tc, E_TOK_NOMATCH, findprefix(tokens, word, &id));
+  freeprefixes(tokens);
+}
+
 CuSuite *get_umlaut_suite(void)
 {
   CuSuite *suite = CuSuiteNew();
   SUITE_ADD_TEST(suite, test_umlaut);
   SUITE_ADD_TEST(suite, test_transliterate);
+  SUITE_ADD_TEST(suite, test_prefix);
+  SUITE_ADD_TEST(suite, test_prefix_long);
   return suite;
 }
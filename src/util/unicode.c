@@ -12,6 +12,7 @@
 #include "unicode.h"
 
 #include <errno.h>
+#include <string.h>
 #include <wctype.h>
 
 #define B00000000 0x00
@@ -30,6 +31,32 @@
 #define B00000011 0x03
 #define B00000001 0x01
 
+#define IS_CONTINUATION(c) (((c) & 0xC0) == 0x80)
+#define ASCII_LOWER(c) (((c) >= 'A' && (c) <= 'Z') ? (c) + ('a' - 'A') : (c))
+
+/* a machine word with the high bit of every byte set */
+#define HIGHBITS (((size_t)-1 / 0xFF) * 0x80)
+
+/** returns the length of the run of ASCII bytes at the start of the buffer.
+ * Checks a machine word at a time, so only use it with a known length. */
+size_t unicode_ascii_span(const char *str, size_t len)
+{
+  size_t i = 0;
+
+  while (i + sizeof(size_t) <= len) {
+    size_t word;
+    memcpy(&word, str + i, sizeof(word));
+    if (word & HIGHBITS) {
+      break;
+    }
+    i += sizeof(size_t);
+  }
+  while (i < len && (~str[i] & 0x80)) {
+    ++i;
+  }
+  return i;
+}
+
 int unicode_utf8_tolower(utf8_t * op, size_t outlen, const utf8_t * ip)
 {
   while (*ip) {
@@ -37,7 +64,16 @@ int unicode_utf8_tolower(utf8_t * op, size_t outlen, const utf8_t * ip)
     ucs4_t low;
     size_t size = 1;
 
-    if (ucs & 0x80) {
+    if (~ucs & 0x80) {
+      /* plain ASCII does not need to be decoded */
+      if (outlen == 0) {
+        return ENOMEM;
+      }
+      *op++ = (utf8_t)ASCII_LOWER(*ip);
+      ++ip;
+      --outlen;
+      continue;
+    } else {
       int ret = unicode_utf8_to_ucs4(&ucs, ip, &size);
       if (ret != 0) {
         return ret;
@@ -78,7 +114,19 @@ unicode_latin1_to_utf8(utf8_t * dst, size_t * outlen, const char *in,
 
   while (ip - in < is) {
     unsigned char c = *ip;
-    if (c > 0xBF) {
+    if (c < 0x80) {
+      /* copy the whole run of ASCII characters */
+      size_t len = unicode_ascii_span(ip, is - (ip - in));
+      if (len > (size_t)(os - (op - out))) {
+        len = os - (op - out);
+        if (len == 0)
+          break;
+      }
+      memcpy(op, ip, len);
+      op += len;
+      ip += len;
+      continue;
+    } else if (c > 0xBF) {
       if (op - out >= os - 1)
         break;
       *op++ = 0xC3;
@@ -107,6 +155,20 @@ int unicode_utf8_strcasecmp(const utf8_t * a, const char *b)
     size_t size;
     ucs4_t ucsa = *a, ucsb = *b;
 
+    if (~(*a | *b) & 0x80) {
+      /* both characters are plain ASCII */
+      if (ucsa != ucsb) {
+        ucsa = ASCII_LOWER(ucsa);
+        ucsb = ASCII_LOWER(ucsb);
+        if (ucsb < ucsa)
+          return 1;
+        if (ucsb > ucsa)
+          return -1;
+      }
+      ++a;
+      ++b;
+      continue;
+    }
     if (ucsa & 0x80) {
       ret = unicode_utf8_to_ucs4(&ucsa, a, &size);
       if (ret != 0)
@@ -213,7 +275,7 @@ unicode_utf8_to_ucs4(ucs4_t * ucs4_character, const utf8_t * utf8_string,
     *length = 1;
   } else if ((utf8_character & 0xE0) == 0xC0) {
     /* A two-byte UTF-8 sequence. Make sure the other byte is good. */
-    if (utf8_string[1] != '\0' && (utf8_string[1] & 0xC0) != 0x80) {
+    if (!IS_CONTINUATION(utf8_string[1])) {
       return EILSEQ;
     }
 
@@ -222,10 +284,8 @@ unicode_utf8_to_ucs4(ucs4_t * ucs4_character, const utf8_t * utf8_string,
     *length = 2;
   } else if ((utf8_character & 0xF0) == 0xE0) {
     /* A three-byte UTF-8 sequence. Make sure the other bytes are
-       good. */
-    if ((utf8_string[1] != '\0') &&
-      (utf8_string[1] & 0xC0) != 0x80 &&
-      (utf8_string[2] != '\0') && (utf8_string[2] & 0xC0) != 0x80) {
+       good, this also stops at the end of the string. */
+    if (!IS_CONTINUATION(utf8_string[1]) || !IS_CONTINUATION(utf8_string[2])) {
       return EILSEQ;
     }
 
@@ -236,11 +296,8 @@ unicode_utf8_to_ucs4(ucs4_t * ucs4_character, const utf8_t * utf8_string,
   } else if ((utf8_character & 0xF8) == 0xF0) {
     /* A four-byte UTF-8 sequence. Make sure the other bytes are
        good. */
-    if ((utf8_string[1] != '\0') &&
-      (utf8_string[1] & 0xC0) != 0x80 &&
-      (utf8_string[2] != '\0') &&
-      (utf8_string[2] & 0xC0) != 0x80 &&
-      (utf8_string[3] != '\0') && (utf8_string[3] & 0xC0) != 0x80) {
+    if (!IS_CONTINUATION(utf8_string[1]) || !IS_CONTINUATION(utf8_string[2])
+      || !IS_CONTINUATION(utf8_string[3])) {
       return EILSEQ;
     }
 
@@ -252,13 +309,8 @@ unicode_utf8_to_ucs4(ucs4_t * ucs4_character, const utf8_t * utf8_string,
   } else if ((utf8_character & 0xFC) == 0xF8) {
     /* A five-byte UTF-8 sequence. Make sure the other bytes are
        good. */
-    if ((utf8_string[1] != '\0') &&
-      (utf8_string[1] & 0xC0) != 0x80 &&
-      (utf8_string[2] != '\0') &&
-      (utf8_string[2] & 0xC0) != 0x80 &&
-      (utf8_string[3] != '\0') &&
-      (utf8_string[3] & 0xC0) != 0x80 &&
-      (utf8_string[4] != '\0') && (utf8_string[4] & 0xC0) != 0x80) {
+    if (!IS_CONTINUATION(utf8_string[1]) || !IS_CONTINUATION(utf8_string[2])
+      || !IS_CONTINUATION(utf8_string[3]) || !IS_CONTINUATION(utf8_string[4])) {
       return EILSEQ;
     }
 
@@ -271,15 +323,9 @@ unicode_utf8_to_ucs4(ucs4_t * ucs4_character, const utf8_t * utf8_string,
   } else if ((utf8_character & 0xFE) == 0xFC) {
     /* A six-byte UTF-8 sequence. Make sure the other bytes are
        good. */
-    if ((utf8_string[1] != '\0') &&
-      (utf8_string[1] & 0xC0) != 0x80 &&
-      (utf8_string[2] != '\0') &&
-      (utf8_string[2] & 0xC0) != 0x80 &&
-      (utf8_string[3] != '\0') &&
-      (utf8_string[3] & 0xC0) != 0x80 &&
-      (utf8_string[4] != '\0') &&
-      (utf8_string[4] & 0xC0) != 0x80 &&
-      (utf8_string[5] != '\0') && (utf8_string[5] & 0xC0) != 0x80) {
+    if (!IS_CONTINUATION(utf8_string[1]) || !IS_CONTINUATION(utf8_string[2])
+      || !IS_CONTINUATION(utf8_string[3]) || !IS_CONTINUATION(utf8_string[4])
+      || !IS_CONTINUATION(utf8_string[5])) {
       return EILSEQ;
     }
 
@@ -314,7 +360,7 @@ unicode_utf8_to_cp437(char *cp_character, const utf8_t * utf8_string,
   if (ucs4_character < 0x7F) {
     *cp_character = (char)ucs4_character;
   } else {
-    struct {
+    static const struct {
       ucs4_t ucs4;
       unsigned char cp437;
     } xref[160] = {
@@ -487,7 +533,7 @@ unicode_utf8_to_cp437(char *cp_character, const utf8_t * utf8_string,
         *cp_character = (char)xref[m].cp437;
         break;
       } else if (xref[m].ucs4 < ucs4_character)
-        l = m;
+        l = m + 1;
       else
         r = m;
     }
@@ -512,46 +558,48 @@ unicode_utf8_to_cp1252(char *cp_character, const utf8_t * utf8_string,
     return result;
   }
 
-  if (ucs4_character <= 0x7F || ucs4_character >= 0xA0) {
+  if (ucs4_character <= 0x7F || (ucs4_character >= 0xA0
+      && ucs4_character <= 0xFF)) {
     *cp_character = (char)ucs4_character;
   } else {
-    struct {
+    static const struct {
       ucs4_t ucs4;
       unsigned char cp;
     } xref[] = {
+      /* sorted by ucs4, for the binary search */
       {
-      0x20ac, 0x80}, {
       0x0081, 0x81}, {
-      0x201a, 0x82}, {
-      0x0192, 0x83}, {
-      0x201e, 0x84}, {
-      0x2026, 0x85}, {
-      0x2020, 0x86}, {
-      0x2021, 0x87}, {
-      0x02c6, 0x88}, {
-      0x2030, 0x89}, {
-      0x0160, 0x8a}, {
-      0x2039, 0x8b}, {
-      0x0152, 0x8c}, {
       0x008d, 0x8d}, {
-      0x017d, 0x8e}, {
       0x008f, 0x8f}, {
       0x0090, 0x90}, {
+      0x009d, 0x9d}, {
+      0x0152, 0x8c}, {
+      0x0153, 0x9c}, {
+      0x0160, 0x8a}, {
+      0x0161, 0x9a}, {
+      0x0178, 0x9f}, {
+      0x017d, 0x8e}, {
+      0x017e, 0x9e}, {
+      0x0192, 0x83}, {
+      0x02c6, 0x88}, {
+      0x02dc, 0x98}, {
+      0x2013, 0x96}, {
+      0x2014, 0x97}, {
       0x2018, 0x91}, {
       0x2019, 0x92}, {
+      0x201a, 0x82}, {
       0x201c, 0x93}, {
       0x201d, 0x94}, {
+      0x201e, 0x84}, {
+      0x2020, 0x86}, {
+      0x2021, 0x87}, {
       0x2022, 0x95}, {
-      0x2013, 0x96}, {
-      0x2014, 0x97}, {
-      0x02dc, 0x98}, {
-      0x2122, 0x99}, {
-      0x0161, 0x9a}, {
+      0x2026, 0x85}, {
+      0x2030, 0x89}, {
+      0x2039, 0x8b}, {
       0x203a, 0x9b}, {
-      0x0153, 0x9c}, {
-      0x009d, 0x9d}, {
-      0x017e, 0x9e}, {
-      0x0178, 0x9f}
+      0x20ac, 0x80}, {
+      0x2122, 0x99}
     };
     int l = 0, r = sizeof(xref) / sizeof(xref[0]);
     while (l != r) {
@@ -560,7 +608,7 @@ unicode_utf8_to_cp1252(char *cp_character, const utf8_t * utf8_string,
         *cp_character = (char)xref[m].cp;
         break;
       } else if (xref[m].ucs4 < ucs4_character)
-        l = m;
+        l = m + 1;
       else
         r = m;
     }
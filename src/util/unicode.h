@@ -41,6 +41,7 @@ extern "C" {
     const char *in, size_t * inlen);
   extern int unicode_utf8_tolower(utf8_t * out, size_t outlen,
     const utf8_t * in);
+  extern size_t unicode_ascii_span(const char *str, size_t len);
 
 #ifdef __cplusplus
 }
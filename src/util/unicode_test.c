@@ -0,0 +1,98 @@
+#include <platform.h>
+#include <CuTest.h>
+#include "unicode.h"
+
+#include <errno.h>
+#include <string.h>
+
+static void test_unicode_tolower(CuTest * tc)
+{
+  char buffer[32];
+
+  CuAssertIntEquals(tc, 0, unicode_utf8_tolower(buffer, sizeof(buffer), "HeLLo World"));
+  CuAssertStrEquals(tc, "hello world", buffer);
+  CuAssertIntEquals(tc, 0, unicode_utf8_tolower(buffer, sizeof(buffer), "H\xc3\xa4LLO"));
+  CuAssertStrEquals(tc, "h\xc3\xa4llo", buffer);
+  CuAssertIntEquals(tc, ENOMEM, unicode_utf8_tolower(buffer, 5, "HELLO"));
+  CuAssertIntEquals(tc, ENOMEM, unicode_utf8_tolower(buffer, 3, "H\xc3\xa4LLO"));
+}
+
+static void test_unicode_strcasecmp(CuTest * tc)
+{
+  CuAssertIntEquals(tc, 0, unicode_utf8_strcasecmp("Hello", "hELLO"));
+  CuAssertIntEquals(tc, 0, unicode_utf8_strcasecmp("Gr\xc3\xbc\xc3\x9f" "e", "GR\xc3\xbc\xc3\x9f" "E"));
+  CuAssertIntEquals(tc, -1, unicode_utf8_strcasecmp("abc", "abd"));
+  CuAssertIntEquals(tc, 1, unicode_utf8_strcasecmp("abd", "ABC"));
+  CuAssertIntEquals(tc, -1, unicode_utf8_strcasecmp("ab", "abc"));
+  CuAssertIntEquals(tc, 1, unicode_utf8_strcasecmp("abc", "ab"));
+  CuAssertIntEquals(tc, -1, unicode_utf8_strcasecmp("a", "\xc3\xa4"));
+}
+
+static void test_unicode_latin1(CuTest * tc)
+{
+  char buffer[64];
+  const char *latin1 = "Gr\xfc\xdf" "e aus der sch\xf6nen Stadt Berlin";
+  size_t inlen = strlen(latin1), outlen = sizeof(buffer) - 1;
+
+  CuAssertIntEquals(tc, (int)inlen + 3, unicode_latin1_to_utf8(buffer, &outlen, latin1, &inlen));
+  buffer[outlen] = 0;
+  CuAssertStrEquals(tc, "Gr\xc3\xbc\xc3\x9f" "e aus der sch\xc3\xb6nen Stadt Berlin", buffer);
+
+  /* the output is limited, and we do not split characters */
+  inlen = strlen(latin1);
+  outlen = 3;
+  CuAssertIntEquals(tc, 2, unicode_latin1_to_utf8(buffer, &outlen, latin1, &inlen));
+  CuAssertIntEquals(tc, 2, (int)inlen);
+  inlen = 30;
+  outlen = 10;
+  CuAssertIntEquals(tc, 10, unicode_latin1_to_utf8(buffer, &outlen, "abcdefghijklmnopqrstuvwxyz0123", &inlen));
+  CuAssertIntEquals(tc, 10, (int)inlen);
+  CuAssertIntEquals(tc, 4, (int)unicode_ascii_span("abcd\xfc" "abcdefghijk", 16));
+  CuAssertIntEquals(tc, 13, (int)unicode_ascii_span("abcdefghijklm\xfc", 14));
+}
+
+static void test_unicode_decode(CuTest * tc)
+{
+  ucs4_t ucs;
+  size_t len;
+
+  CuAssertIntEquals(tc, 0, unicode_utf8_to_ucs4(&ucs, "\xe2\x82\xac", &len));
+  CuAssertIntEquals(tc, 0x20ac, (int)ucs);
+  CuAssertIntEquals(tc, 3, (int)len);
+  CuAssertIntEquals(tc, 0, unicode_utf8_to_ucs4(&ucs, "\xc3\xa4", &len));
+  CuAssertIntEquals(tc, 0xe4, (int)ucs);
+  CuAssertIntEquals(tc, 2, (int)len);
+  /* truncated sequences must not run past the end of the string */
+  CuAssertIntEquals(tc, EILSEQ, unicode_utf8_to_ucs4(&ucs, "\xc3", &len));
+  CuAssertIntEquals(tc, EILSEQ, unicode_utf8_to_ucs4(&ucs, "\xe2\x82", &len));
+  CuAssertIntEquals(tc, EILSEQ, unicode_utf8_to_ucs4(&ucs, "\xe2" "ab", &len));
+}
+
+static void test_unicode_codepages(CuTest * tc)
+{
+  char c;
+  size_t len;
+
+  CuAssertIntEquals(tc, 0, unicode_utf8_to_cp437(&c, "\xc3\xa4", &len));
+  CuAssertIntEquals(tc, 132, (unsigned char)c);
+  /* not in the table, between two entries */
+  CuAssertIntEquals(tc, 0, unicode_utf8_to_cp437(&c, "\xc2\xa4", &len));
+  CuAssertIntEquals(tc, '?', c);
+  CuAssertIntEquals(tc, 0, unicode_utf8_to_cp1252(&c, "\xe2\x82\xac", &len));
+  CuAssertIntEquals(tc, 0x80, (unsigned char)c);
+  CuAssertIntEquals(tc, 0, unicode_utf8_to_cp1252(&c, "\xc3\xa4", &len));
+  CuAssertIntEquals(tc, 0xe4, (unsigned char)c);
+  CuAssertIntEquals(tc, 0, unicode_utf8_to_cp1252(&c, "\xe2\x80\x9e", &len));
+  CuAssertIntEquals(tc, 0x84, (unsigned char)c);
+}
+
+CuSuite *get_unicode_suite(void)
+{
+  CuSuite *suite = CuSuiteNew();
+  SUITE_ADD_TEST(suite, test_unicode_tolower);
+  SUITE_ADD_TEST(suite, test_unicode_strcasecmp);
+  SUITE_ADD_TEST(suite, test_unicode_latin1);
+  SUITE_ADD_TEST(suite, test_unicode_decode);
+  SUITE_ADD_TEST(suite, test_unicode_codepages);
+  return suite;
+}
@@ -722,7 +722,7 @@ static xmlNodePtr report_root(report_context * ctx)
 {
   int qi;
   quicklist *address;
-  region *r = ctx->first, *rend = ctx->last;
+  seen_region *sr, *send = ctx->seen->regions + ctx->seen->size;
   xml_context *xct = (xml_context *) ctx->userdata;
   xmlNodePtr node, child, xmlReport = xmlNewNode(NULL, BAD_CAST "atlantis");
   const char *mailto = locale_string(ctx->f->locale, "mailto");
@@ -754,10 +754,8 @@ static xmlNodePtr report_root(report_context * ctx)
     xmlAddChild(xmlReport, xml_faction(ctx, f));
   }
 
-  for (; r != rend; r = r->next) {
-    seen_region *sr = find_seen(ctx->seen, r);
-    if (sr != NULL)
-      xmlAddChild(xmlReport, xml_region(ctx, sr));
+  for (sr = ctx->seen->regions; sr != send; ++sr) {
+    xmlAddChild(xmlReport, xml_region(ctx, sr));
   }
   return xmlReport;
 }